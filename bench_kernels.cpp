@@ -0,0 +1,150 @@
+// Times the whole-board SOS count kernels on large boards: each SIMD level
+// this CPU runs against the scalar kernel, and all of them against a
+// per-cell byte scan of the same position. Both kernel families are timed:
+// over prebuilt line views, and straight over the framed cell bytes. The
+// last rows time Board::countAllSOS end to end with and without
+// TRACK_LINE_VIEWS, and what building the views for each call would cost.
+//
+//   bench_kernels [size ...]      (default 1024 2048)
+
+#include "board.h"
+#include "soskernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+const double FILL = 0.6;
+// Cells counted per timing, so small boards repeat enough to measure
+const long long TARGET_CELLS = 1LL << 28;
+
+// Every SOS found by walking the byte buffer, three compares per line
+int byteScan(const Board& board) {
+    const uint8_t S = static_cast<uint8_t>(CellState::S);
+    const uint8_t O = static_cast<uint8_t>(CellState::O);
+    const uint8_t* cells = board.data();
+    int stride = board.getStride();
+    const int steps[4] = {1, stride, stride + 1, stride - 1};
+    int count = 0;
+    for (int row = 0; row < board.getSize(); row++) {
+        const uint8_t* c = cells + board.index(row, 0);
+        for (int col = 0; col < board.getSize(); col++, c++) {
+            for (int d : steps) {
+                count += (c[0] == S) & (c[d] == O) & (c[2 * d] == S);
+            }
+        }
+    }
+    return count;
+}
+
+int viewCount(const Board& board, soskernels::CountTriplesFn kernel) {
+    int count = 0;
+    for (int line = 0; line < Board::LINE_COUNT; line++) {
+        const Board::LineView& view = board.getView(static_cast<Board::Line>(line));
+        count += kernel(view.s.data(), view.o.data(), view.s.wordCount());
+    }
+    return count;
+}
+
+// Nanoseconds per board cell for one whole-board count
+template <typename Count>
+double timePerCell(int size, int repeats, Count count, long long& checksum) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) {
+        checksum += count();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           (static_cast<double>(repeats) * size * size);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++) {
+        sizes.push_back(std::atoi(argv[i]));
+    }
+    if (sizes.empty()) {
+        sizes = {1024, 2048};
+    }
+
+    std::printf("%-10s %6s %12s %10s %10s\n", "kernel", "size", "per cell", "vs scalar", "vs bytes");
+    for (int size : sizes) {
+        std::mt19937 rng(12);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        Board board(size, Board::TRACK_LINE_VIEWS);
+        for (int row = 0; row < size; row++) {
+            for (int col = 0; col < size; col++) {
+                if (unit(rng) < FILL) {
+                    board.makeMove(row, col, unit(rng) < 0.6 ? 'S' : 'O');
+                }
+            }
+        }
+
+        int repeats = static_cast<int>(std::max(1LL, TARGET_CELLS / (static_cast<long long>(size) * size)));
+        long long checksum = 0;
+        int expected = byteScan(board);
+
+        double bytes = timePerCell(size, repeats, [&] { return byteScan(board); }, checksum);
+        std::printf("%-10s %6d %9.3f ns %10s %9.2fx\n", "byte scan", size, bytes, "", 1.0);
+
+        double scalar = 0;
+        for (int level = 0; level <= static_cast<int>(detectedSimdLevel()); level++) {
+            SimdLevel simd = static_cast<SimdLevel>(level);
+            soskernels::CountTriplesFn kernel = soskernels::countTriplesFor(simd);
+            if (viewCount(board, kernel) != expected) {
+                std::printf("%s kernel disagrees with the byte scan\n", simdLevelName(simd));
+                return 1;
+            }
+            double ns = timePerCell(size, repeats, [&] { return viewCount(board, kernel); }, checksum);
+            if (level == 0) {
+                scalar = ns;
+            }
+            std::printf("%-10s %6d %9.3f ns %9.2fx %9.2fx\n", simdLevelName(simd), size, ns,
+                        scalar / ns, bytes / ns);
+        }
+
+        // The cell-buffer kernels an untracked board counts with
+        std::printf("cell bytes:\n");
+        for (int level = 0; level <= static_cast<int>(detectedSimdLevel()); level++) {
+            SimdLevel simd = static_cast<SimdLevel>(level);
+            soskernels::CountFramedTriplesFn kernel = soskernels::countFramedTriplesFor(simd);
+            auto count = [&] { return kernel(board.data(), size, board.getStride()); };
+            if (count() != expected) {
+                std::printf("%s cell kernel disagrees with the byte scan\n", simdLevelName(simd));
+                return 1;
+            }
+            double ns = timePerCell(size, repeats, count, checksum);
+            if (level == 0) {
+                scalar = ns;
+            }
+            std::printf("%-10s %6d %9.3f ns %9.2fx %9.2fx\n", simdLevelName(simd), size, ns,
+                        scalar / ns, bytes / ns);
+        }
+
+        // End to end through the Board, at the active level; "rebuilt"
+        // builds the views for every count, as untracked boards once did
+        std::printf("countAllSOS (%s):\n", simdLevelName(activeSimdLevel()));
+        Board untracked = board;
+        untracked.setTracking(Board::TRACK_NONE);
+        double viewsKept = timePerCell(size, repeats, [&] { return board.countAllSOS(); }, checksum);
+        double noViews = timePerCell(size, repeats, [&] { return untracked.countAllSOS(); }, checksum);
+        double viewsBuilt = timePerCell(size, repeats, [&] {
+            untracked.setTracking(Board::TRACK_LINE_VIEWS);
+            int count = untracked.countAllSOS();
+            untracked.setTracking(Board::TRACK_NONE);
+            return count;
+        }, checksum);
+        const char* row = "%-10s %6d %9.3f ns %10s %9.2fx\n";
+        std::printf(row, "views kept", size, viewsKept, "", bytes / viewsKept);
+        std::printf(row, "untracked", size, noViews, "", bytes / noViews);
+        std::printf(row, "rebuilt", size, viewsBuilt, "", bytes / viewsBuilt);
+        std::printf("(checksum %lld)\n", checksum);
+    }
+    return 0;
+}
@@ -0,0 +1,193 @@
+// Compares LayoutBoard cell orders on large boards: time per neighbourhood
+// lookup, cache lines and pages each lookup touches, and, where Linux perf
+// counters are available, hardware cache misses per lookup.
+//
+//   bench_layout [size ...]      (default 1024 2048 4096)
+
+#include "layoutboard.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <vector>
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+// Counter ids are unused without perf; PerfCounter always reads -1
+#define PERF_TYPE_HARDWARE 0
+#define PERF_TYPE_HW_CACHE 0
+#define PERF_COUNT_HW_CACHE_MISSES 0
+#define PERF_COUNT_HW_CACHE_L1D 0
+#define PERF_COUNT_HW_CACHE_OP_READ 0
+#define PERF_COUNT_HW_CACHE_RESULT_MISS 0
+#endif
+
+namespace {
+
+const int LOOKUPS = 4000000;
+const double FILL = 0.4;
+
+// One hardware counter; reads -1 when the kernel doesn't allow it
+class PerfCounter {
+    int fd = -1;
+
+public:
+    PerfCounter(uint32_t type, uint64_t config) {
+#if defined(__linux__)
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+        (void)type;
+        (void)config;
+#endif
+    }
+    ~PerfCounter() {
+#if defined(__linux__)
+        if (fd >= 0) {
+            close(fd);
+        }
+#endif
+    }
+
+    void start() {
+#if defined(__linux__)
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long stop() {
+#if defined(__linux__)
+        long long value = 0;
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &value, sizeof(value)) == sizeof(value)) {
+                return value;
+            }
+        }
+#endif
+        return -1;
+    }
+};
+
+struct Query {
+    int row;
+    int col;
+};
+
+// Distinct cache lines and pages among the 17 cells a lookup reads
+template <typename Layout>
+void footprint(const LayoutBoard<Layout>& board, const std::vector<Query>& queries,
+               double& lines, double& pages) {
+    const int steps[4][2] = {{0, 1}, {1, 0}, {1, 1}, {-1, 1}};
+    const size_t sample = 100000;
+    size_t lineTotal = 0;
+    size_t pageTotal = 0;
+
+    for (size_t q = 0; q < sample && q < queries.size(); q++) {
+        std::set<size_t> lineSet;
+        std::set<size_t> pageSet;
+        for (const auto& step : steps) {
+            for (int k = -2; k <= 2; k++) {
+                size_t offset = board.offsetOf(queries[q].row + k * step[0],
+                                               queries[q].col + k * step[1]);
+                lineSet.insert(offset / 64);
+                pageSet.insert(offset / 4096);
+            }
+        }
+        lineTotal += lineSet.size();
+        pageTotal += pageSet.size();
+    }
+    size_t n = std::min(sample, queries.size());
+    lines = static_cast<double>(lineTotal) / n;
+    pages = static_cast<double>(pageTotal) / n;
+}
+
+template <typename Layout>
+void run(const char* name, int size, const std::vector<Query>& moves,
+         const std::vector<Query>& queries) {
+    LayoutBoard<Layout> board(size);
+    for (size_t i = 0; i < moves.size(); i++) {
+        board.makeMove(moves[i].row, moves[i].col, (i % 3 == 0) ? 'O' : 'S');
+    }
+
+    double lines, pages;
+    footprint(board, queries, lines, pages);
+
+    PerfCounter misses(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    PerfCounter l1Misses(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                                                 (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                                 (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+
+    long long checksum = 0;
+    misses.start();
+    l1Misses.start();
+    auto start = std::chrono::steady_clock::now();
+    for (const Query& q : queries) {
+        checksum += board.isEmpty(q.row, q.col) ? board.checkForSOS(q.row, q.col, 'S')
+                                                : board.checkForSOS(q.row, q.col);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    long long l1 = l1Misses.stop();
+    long long llc = misses.stop();
+
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / queries.size();
+    std::printf("%-10s %6d %8.1f MB %8.2f ns %7.2f lines %6.2f pages", name, size,
+                board.memoryBytes() / 1048576.0, ns, lines, pages);
+    if (l1 >= 0) {
+        std::printf(" %7.3f L1 miss", static_cast<double>(l1) / queries.size());
+    }
+    if (llc >= 0) {
+        std::printf(" %7.3f LLC miss", static_cast<double>(llc) / queries.size());
+    }
+    std::printf("   (checksum %lld)\n", checksum);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++) {
+        sizes.push_back(std::atoi(argv[i]));
+    }
+    if (sizes.empty()) {
+        sizes = {1024, 2048, 4096};
+    }
+
+    std::printf("%-10s %6s %11s %11s %13s %12s\n", "layout", "size", "memory", "lookup",
+                "lines/lookup", "pages/lookup");
+    for (int size : sizes) {
+        std::mt19937 rng(449);
+        std::uniform_int_distribution<int> coord(0, size - 1);
+
+        std::vector<Query> moves(static_cast<size_t>(FILL * size * size));
+        for (Query& m : moves) {
+            m = {coord(rng), coord(rng)};
+        }
+        std::vector<Query> queries(LOOKUPS);
+        for (Query& q : queries) {
+            q = {coord(rng), coord(rng)};
+        }
+
+        run<RowMajorLayout>("row-major", size, moves, queries);
+        run<TiledLayout>("tiled", size, moves, queries);
+        run<MortonLayout>("morton", size, moves, queries);
+    }
+    return 0;
+}
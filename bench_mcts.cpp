@@ -0,0 +1,70 @@
+// Thread scaling of the tree-parallel MCTS: playouts per second on fixed
+// positions for each worker count from 1 up to the maximum.
+//
+//   bench_mcts [max threads] [ms per run]   (default hardware threads, 1000)
+
+#include "mcts.h"
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Position {
+    const char* name;
+    Board board;
+    GameMode mode;
+};
+
+// A deterministic midgame: 'moves' letters on a fixed pseudo-random
+// pattern, skipping cells that would score so the position stays quiet
+Board midgame(int size, int moves) {
+    Board board(size);
+    uint32_t state = 12345;
+    int placed = 0;
+    while (placed < moves) {
+        state = state * 1103515245u + 12345u;
+        int row = (state >> 8) % size;
+        int col = (state >> 20) % size;
+        char letter = (state >> 30) & 1 ? 'O' : 'S';
+        if (board.isEmpty(row, col) && board.checkForSOS(row, col, letter) == 0) {
+            board.makeMove(row, col, letter);
+            placed++;
+        }
+    }
+    return board;
+}
+
+}
+
+int main(int argc, char** argv) {
+    int maxThreads = argc > 1 ? atoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency());
+    int timeMs = argc > 2 ? atoi(argv[2]) : 1000;
+    if (maxThreads < 1) {
+        maxThreads = 1;
+    }
+
+    std::vector<Position> positions = {
+        {"8x8 empty, simple", Board(8), GameMode::SIMPLE},
+        {"12x12 midgame, general", midgame(12, 40), GameMode::GENERAL},
+        {"20x20 midgame, general", midgame(20, 120), GameMode::GENERAL},
+    };
+
+    MctsEngine engine;
+    for (const Position& position : positions) {
+        printf("%s\n", position.name);
+        printf("  threads  playouts/s  speedup     nodes\n");
+        double base = 0;
+        for (int threads = 1; threads <= maxThreads; threads++) {
+            MctsResult result;
+            engine.search(position.board, position.mode, 0, {timeMs, 0, 0, threads}, result);
+            if (threads == 1) {
+                base = result.playoutsPerSecond;
+            }
+            printf("  %7d  %10.0f  %6.2fx  %8zu\n", threads, result.playoutsPerSecond,
+                   base > 0 ? result.playoutsPerSecond / base : 0.0, result.nodes);
+        }
+    }
+    return 0;
+}
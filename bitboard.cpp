@@ -0,0 +1,29 @@
+#include "bitboard.h"
+#include <algorithm>
+
+Bitboard::Bitboard(int bits) : bitCount(bits), words((bits + 63) / 64, 0) {}
+
+int Bitboard::count() const {
+    int total = 0;
+    for (uint64_t w : words) {
+        total += popcount64(w);
+    }
+    return total;
+}
+
+bool Bitboard::any() const {
+    for (uint64_t w : words) {
+        if (w != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Bitboard::clearAll() {
+    std::fill(words.begin(), words.end(), 0);
+}
+
+bool Bitboard::operator==(const Bitboard& other) const {
+    return bitCount == other.bitCount && words == other.words;
+}
@@ -0,0 +1,58 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+inline int popcount64(uint64_t word) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(word));
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+// Fixed-length bit set stored in 64-bit words, one bit per board cell.
+// Bits past the end of the last word are always kept at zero.
+class Bitboard {
+private:
+    int bitCount;
+    std::vector<uint64_t> words;
+
+public:
+    Bitboard(int bits = 0);
+
+    int size() const { return bitCount; }
+    int wordCount() const { return static_cast<int>(words.size()); }
+    uint64_t word(int i) const { return words[i]; }
+    const uint64_t* data() const { return words.data(); }
+
+    bool test(int bit) const { return (words[bit >> 6] >> (bit & 63)) & 1; }
+    void set(int bit) { words[bit >> 6] |= uint64_t(1) << (bit & 63); }
+    void clear(int bit) { words[bit >> 6] &= ~(uint64_t(1) << (bit & 63)); }
+
+    // Up to 57 consecutive bits starting at 'start', lowest bit first.
+    // Bits outside the set read as zero.
+    uint64_t bits(int start, int n) const {
+        int w = start >> 6;
+        int off = start & 63;
+        uint64_t v = words[w] >> off;
+        if (off + n > 64 && w + 1 < static_cast<int>(words.size())) {
+            v |= words[w + 1] << (64 - off);
+        }
+        return v & ((uint64_t(1) << n) - 1);
+    }
+
+    int count() const;
+    bool any() const;
+    void clearAll();
+
+    bool operator==(const Bitboard& other) const;
+    bool operator!=(const Bitboard& other) const { return !(*this == other); }
+};
+
+#endif // BITBOARD_H
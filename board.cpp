@@ -1,10 +1,66 @@
 #include "board.h"
+#include "zobrist.h"
+#include "soskernels.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
 
-Board::Board(int boardSize) : size(boardSize) {
+namespace {
+// SOS count through the centre of a 5-cell line code (2 bits per cell,
+// centre in bits 4-5). EMPTY and BORDER never match, so a code read next
+// to the frame needs no special handling.
+constexpr std::array<uint8_t, 1024> buildSOSTable() {
+    std::array<uint8_t, 1024> table{};
+    for (int code = 0; code < 1024; code++) {
+        int cellsOnLine[5] = {};
+        for (int i = 0; i < 5; i++) {
+            cellsOnLine[i] = (code >> (2 * i)) & 3;
+        }
+        int count = 0;
+        for (int start = 0; start <= 2; start++) {
+            if (cellsOnLine[start] == static_cast<int>(CellState::S) &&
+                cellsOnLine[start + 1] == static_cast<int>(CellState::O) &&
+                cellsOnLine[start + 2] == static_cast<int>(CellState::S)) {
+                count++;
+            }
+        }
+        table[code] = static_cast<uint8_t>(count);
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 1024> SOS_TABLE = buildSOSTable();
+
+static_assert(SOS_TABLE[0x019] == 1, "S O [S] . . completes one SOS");
+static_assert(SOS_TABLE[0x064] == 1, ". S [O] S . completes one SOS");
+static_assert(SOS_TABLE[0x199] == 2, "S O [S] O S completes two SOS");
+static_assert(SOS_TABLE[0x39B] == 0, "BORDER never matches");
+
+// Frees a table that tracking no longer needs
+template <typename T>
+void release(std::vector<T>& table) {
+    std::vector<T>().swap(table);
+}
+}
+
+Board::Board(int boardSize, unsigned trackingFlags) : size(boardSize), tracking(trackingFlags) {
     if (boardSize < 3) {
         size = 3; // Minimum valid size
     }
-    grid.resize(size, std::vector<CellState>(size, CellState::EMPTY));
+    std::fill(symKeys, symKeys + 8, zobrist::boardKey(size));
+    stride = size + 4;
+    cells.assign(stride * stride, BORDER);
+    for (int row = 0; row < size; row++) {
+        std::fill_n(cells.begin() + index(row, 0), size, static_cast<uint8_t>(CellState::EMPTY));
+    }
+    lineSteps[HORIZONTAL] = 1;
+    lineSteps[VERTICAL] = stride;
+    lineSteps[DIAGONAL] = stride + 1;
+    lineSteps[ANTI_DIAGONAL] = 1 - stride;
+
+    emptySlot.resize(size * size);
+    fillEmptySet();
+    buildTracking();
 }
 
 bool Board::isValidSize(int boardSize) const {
@@ -15,113 +71,558 @@ int Board::getSize() const {
     return size;
 }
 
+void Board::setTracking(unsigned trackingFlags) {
+    if (trackingFlags != tracking) {
+        tracking = trackingFlags;
+        buildTracking();
+    }
+}
+
+void Board::buildTracking() {
+    if (tracking & TRACK_LINE_VIEWS) {
+        buildViews(views);
+    } else {
+        for (LineView& view : views) {
+            view = LineView();
+        }
+    }
+
+    if (tracking & TRACK_NEIGHBOURHOOD) {
+        neighbourhood.assign(cells.size(), 0);
+    } else {
+        release(neighbourhood);
+    }
+
+    if (tracking & TRACK_THREATS) {
+        sGains.assign(cells.size(), 0);
+        oGains.assign(cells.size(), 0);
+        scoringCells.clear();
+        scoringSlot.assign(cells.size(), -1);
+    } else {
+        release(sGains);
+        release(oGains);
+        release(scoringCells);
+        release(scoringSlot);
+    }
+
+    if (tracking & TRACK_TRIPLES) {
+        initTriples();
+    } else {
+        release(triples);
+        release(cellLive);
+        release(sSetupCounts);
+        release(oSetupCounts);
+        release(safeCells);
+        release(safeSlot);
+        liveTriples = 0;
+        nearTriples = 0;
+        completedTriples = 0;
+    }
+
+    std::fill(symKeys + 1, symKeys + 8, zobrist::boardKey(size));
+
+    // The placed letters sit past the end of the empty set. Threats are
+    // refreshed last, once every code around them is in place.
+    for (int i = emptyTotal; i < size * size; i++) {
+        int at = index(emptyCells[i] / size, emptyCells[i] % size);
+        CellState letter = static_cast<CellState>(cells[at]);
+        if (tracking & TRACK_NEIGHBOURHOOD) {
+            updateNeighbourhood(at, letter);
+        }
+        if (tracking & TRACK_TRIPLES) {
+            updateTriples(at, letter, 1);
+        }
+        if (tracking & TRACK_SYMMETRY) {
+            toggleSymmetricKeys(emptyCells[i] / size, emptyCells[i] % size, letter);
+        }
+    }
+    if (tracking & TRACK_THREATS) {
+        for (int i = emptyTotal; i < size * size; i++) {
+            refreshThreats(index(emptyCells[i] / size, emptyCells[i] % size));
+        }
+    }
+}
+
 CellState Board::getCell(int row, int col) const {
     if (row >= 0 && row < size && col >= 0 && col < size) {
-        return grid[row][col];
+        return cellAt(row, col);
     }
     return CellState::EMPTY;
 }
 
 bool Board::isEmpty(int row, int col) const {
-    return getCell(row, col) == CellState::EMPTY;
+    if (row < 0 || row >= size || col < 0 || col >= size) {
+        return true;
+    }
+    return cellAt(row, col) == CellState::EMPTY;
 }
 
 bool Board::isFull() const {
-    for (int i = 0; i < size; i++) {
-        for (int j = 0; j < size; j++) {
-            if (grid[i][j] == CellState::EMPTY) {
-                return false;
-            }
-        }
+    return emptyTotal == 0;
+}
+
+bool Board::randomEmptyCell(int& row, int& col, std::mt19937& rng) const {
+    if (emptyTotal == 0) {
+        return false;
     }
+    emptyCellAt(static_cast<int>(rng() % emptyTotal), row, col);
     return true;
 }
 
+void Board::fillEmptySet() {
+    emptyCells.resize(size * size);
+    for (int i = 0; i < size * size; i++) {
+        emptyCells[i] = i;
+        emptySlot[i] = i;
+    }
+    emptyTotal = size * size;
+}
+
+void Board::removeEmpty(int cell) {
+    swapEmptySlots(cell, emptyCells[emptyTotal - 1]);
+    emptyTotal--;
+}
+
+void Board::addEmpty(int cell) {
+    swapEmptySlots(cell, emptyCells[emptyTotal]);
+    emptyTotal++;
+}
+
+void Board::swapEmptySlots(int a, int b) {
+    int slotA = emptySlot[a];
+    int slotB = emptySlot[b];
+    emptyCells[slotA] = b;
+    emptyCells[slotB] = a;
+    emptySlot[a] = slotB;
+    emptySlot[b] = slotA;
+}
+
 bool Board::makeMove(int row, int col, char letter) {
     if (row < 0 || row >= size || col < 0 || col >= size) {
         return false;
     }
 
-    if (!isEmpty(row, col)) {
+    uint8_t& cell = cells[index(row, col)];
+    if (cell != static_cast<uint8_t>(CellState::EMPTY)) {
         return false;
     }
 
-    if (letter == 'S') {
-        grid[row][col] = CellState::S;
-    } else if (letter == 'O') {
-        grid[row][col] = CellState::O;
-    } else {
+    if (letter != 'S' && letter != 'O') {
         return false;
     }
 
+    CellState placed = letter == 'S' ? CellState::S : CellState::O;
+    cell = static_cast<uint8_t>(placed);
+    int at = index(row, col);
+    removeEmpty(row * size + col);
+    toggleKeys(row, col, placed);
+    if (tracking & TRACK_LINE_VIEWS) {
+        updateViews(views, row, col, placed, true);
+    }
+    if (tracking & TRACK_NEIGHBOURHOOD) {
+        updateNeighbourhood(at, placed);
+    }
+    if (tracking & TRACK_THREATS) {
+        refreshThreats(at);
+    }
+    if (tracking & TRACK_TRIPLES) {
+        updateTriples(at, placed, 1);
+    }
     return true;
 }
 
-int Board::checkForSOS(int row, int col) const {
-    int count = 0;
-    CellState placed = getCell(row, col);
+bool Board::unmakeMove(int row, int col) {
+    if (row < 0 || row >= size || col < 0 || col >= size) {
+        return false;
+    }
+
+    uint8_t& cell = cells[index(row, col)];
+    CellState letter = static_cast<CellState>(cell);
+    if (letter == CellState::EMPTY) {
+        return false;
+    }
+
+    int at = index(row, col);
+    toggleKeys(row, col, letter);
+    if (tracking & TRACK_LINE_VIEWS) {
+        updateViews(views, row, col, letter, false);
+    }
+    addEmpty(row * size + col);
+    cell = static_cast<uint8_t>(CellState::EMPTY);
+    if (tracking & TRACK_NEIGHBOURHOOD) {
+        updateNeighbourhood(at, CellState::EMPTY);
+    }
+    if (tracking & TRACK_THREATS) {
+        refreshThreats(at);
+    }
+    if (tracking & TRACK_TRIPLES) {
+        updateTriples(at, letter, -1);
+    }
+    return true;
+}
+
+void Board::initTriples() {
+    int bufferSize = static_cast<int>(cells.size());
+    triples.assign(LINE_COUNT * bufferSize, 8 << 2);
+    cellLive.assign(bufferSize, 0);
+    liveTriples = 0;
+    nearTriples = 0;
+    completedTriples = 0;
+
+    // An empty board sets nothing up, so every cell is safe
+    sSetupCounts.assign(bufferSize, 0);
+    oSetupCounts.assign(bufferSize, 0);
+    safeCells.clear();
+    safeSlot.assign(bufferSize, -1);
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            safeSlot[index(row, col)] = static_cast<int>(safeCells.size());
+            safeCells.push_back(index(row, col));
+        }
+    }
 
-    if (placed == CellState::S) {
-        // When S is placed, check if it COMPLETES any S-O-S sequences
-        // We only look BACKWARD to see if there's already S-O waiting for this S
-
-        // 8 directions to check backward
-        int directions[8][2] = {
-            {-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
-            {0, 1}, {1, -1}, {1, 0}, {1, 1}
-        };
-
-        for (int i = 0; i < 8; i++) {
-            int oRow = row - directions[i][0];      // O should be here
-            int oCol = col - directions[i][1];
-            int sRow = row - 2*directions[i][0];    // Starting S should be here
-            int sCol = col - 2*directions[i][1];
-
-            if (sRow >= 0 && sRow < size && sCol >= 0 && sCol < size &&
-                oRow >= 0 && oRow < size && oCol >= 0 && oCol < size) {
-                if (getCell(sRow, sCol) == CellState::S &&
-                    getCell(oRow, oCol) == CellState::O) {
-                    count++;
+    const uint8_t border = BORDER;
+    for (int line = 0; line < LINE_COUNT; line++) {
+        int d = lineSteps[line];
+        for (int row = 0; row < size; row++) {
+            for (int col = 0; col < size; col++) {
+                int start = index(row, col);
+                if (cells[start + d] == border || cells[start + 2 * d] == border) {
+                    continue;
+                }
+                triples[line * bufferSize + start] = 0;
+                liveTriples++;
+                for (int k = 0; k < 3; k++) {
+                    cellLive[start + k * d]++;
                 }
             }
         }
-    } else if (placed == CellState::O) {
-        // When O is placed, check if it's between two S's in ANY direction
-        // We check 4 LINES (each line has 2 opposite directions)
-        // This avoids double counting the same SOS
-
-        int lines[4][2] = {
-            {-1, 0},  // vertical line: up/down
-            {0, 1},   // horizontal line: left/right
-            {-1, 1},  // diagonal line: up-right/down-left ↗↙
-            {1, 1}    // diagonal line: down-right/up-left ↘↖
-        };
-
-        for (int i = 0; i < 4; i++) {
-            int s1Row = row + lines[i][0];
-            int s1Col = col + lines[i][1];
-            int s2Row = row - lines[i][0];
-            int s2Col = col - lines[i][1];
-
-            if (s1Row >= 0 && s1Row < size && s1Col >= 0 && s1Col < size &&
-                s2Row >= 0 && s2Row < size && s2Col >= 0 && s2Col < size) {
-
-                if (getCell(s1Row, s1Col) == CellState::S &&
-                    getCell(s2Row, s2Col) == CellState::S) {
-                    count++;
+    }
+}
+
+void Board::updateTriples(int index, CellState letter, int delta) {
+    int bufferSize = static_cast<int>(cells.size());
+
+    // The cell is position k (0-2) of the triple starting k steps back
+    for (int line = 0; line < LINE_COUNT; line++) {
+        int d = lineSteps[line];
+        for (int k = 0; k < 3; k++) {
+            int start = index - k * d;
+            uint8_t& state = triples[line * bufferSize + start];
+
+            int fits = state & 3;
+            int misfits = state >> 2;
+            bool wasLive = misfits == 0 && fits < 3;
+            bool wasSetup = misfits == 0 && fits == 1;
+            bool wasNear = wasLive && fits == 2;
+            bool wasDone = misfits == 0 && fits == 3;
+
+            CellState wanted = (k == 1) ? CellState::O : CellState::S;
+            if (letter == wanted) {
+                fits += delta;
+            } else {
+                misfits += delta;
+            }
+            state = static_cast<uint8_t>((misfits << 2) | fits);
+
+            bool isLive = misfits == 0 && fits < 3;
+            bool isSetup = misfits == 0 && fits == 1;
+            bool isNear = isLive && fits == 2;
+            bool isDone = misfits == 0 && fits == 3;
+
+            nearTriples += isNear - wasNear;
+            completedTriples += isDone - wasDone;
+            if (isLive != wasLive) {
+                int change = isLive ? 1 : -1;
+                liveTriples += change;
+                for (int j = 0; j < 3; j++) {
+                    cellLive[start + j * d] += change;
+                }
+            }
+            if (isSetup != wasSetup) {
+                int change = isSetup ? 1 : -1;
+                for (int j = 0; j < 3; j++) {
+                    int cell = start + j * d;
+                    (j == 1 ? oSetupCounts : sSetupCounts)[cell] += change;
+                    refreshSafe(cell);
                 }
             }
         }
     }
+    refreshSafe(index);
+}
+
+void Board::refreshSafe(int index) {
+    bool safe = cells[index] == static_cast<uint8_t>(CellState::EMPTY) &&
+                (sSetupCounts[index] == 0 || oSetupCounts[index] == 0);
+    int slot = safeSlot[index];
+    if (safe && slot < 0) {
+        safeSlot[index] = static_cast<int>(safeCells.size());
+        safeCells.push_back(index);
+    } else if (!safe && slot >= 0) {
+        int last = safeCells.back();
+        safeCells[slot] = last;
+        safeSlot[last] = slot;
+        safeCells.pop_back();
+        safeSlot[index] = -1;
+    }
+}
+
+void Board::toggleKeys(int row, int col, CellState letter) {
+    symKeys[0] ^= zobrist::cellKey(size, row * size + col, letter);
+    if (tracking & TRACK_SYMMETRY) {
+        toggleSymmetricKeys(row, col, letter);
+    }
+}
+
+void Board::toggleSymmetricKeys(int row, int col, CellState letter) {
+    for (int sym = 1; sym < 8; sym++) {
+        int r, c;
+        transformCell(sym, size, row, col, r, c);
+        symKeys[sym] ^= zobrist::cellKey(size, r * size + c, letter);
+    }
+}
+
+void Board::transformCell(int symmetry, int size, int row, int col, int& outRow, int& outCol) {
+    int last = size - 1;
+    switch (symmetry) {
+    case 0: outRow = row;        outCol = col;        break;
+    case 1: outRow = col;        outCol = last - row; break;
+    case 2: outRow = last - row; outCol = last - col; break;
+    case 3: outRow = last - col; outCol = row;        break;
+    case 4: outRow = row;        outCol = last - col; break;
+    case 5: outRow = last - row; outCol = col;        break;
+    case 6: outRow = col;        outCol = row;        break;
+    default: outRow = last - col; outCol = last - row; break;
+    }
+}
+
+int Board::inverseSymmetry(int symmetry) {
+    // Only the quarter turns are not their own inverse
+    if (symmetry == 1) return 3;
+    if (symmetry == 3) return 1;
+    return symmetry;
+}
+
+int Board::canonicalSymmetry() const {
+    int best = 0;
+    for (int sym = 1; sym < 8; sym++) {
+        if (symKeys[sym] < symKeys[best]) {
+            best = sym;
+        }
+    }
+    return best;
+}
+
+uint64_t Board::canonicalKey() const {
+    return symKeys[canonicalSymmetry()];
+}
 
+void Board::toCanonical(int row, int col, int& outRow, int& outCol) const {
+    transformCell(canonicalSymmetry(), size, row, col, outRow, outCol);
+}
+
+void Board::fromCanonical(int row, int col, int& outRow, int& outCol) const {
+    transformCell(inverseSymmetry(canonicalSymmetry()), size, row, col, outRow, outCol);
+}
+
+void Board::updateNeighbourhood(int index, CellState letter) {
+    uint64_t value = static_cast<uint64_t>(letter);
+
+    // The cell k steps along a line sees this one in slot 2 - k of its code
+    for (int line = 0; line < LINE_COUNT; line++) {
+        int d = lineSteps[line];
+        for (int k = -2; k <= 2; k++) {
+            int shift = 10 * line + 2 * (2 - k);
+            uint64_t& code = neighbourhood[index + k * d];
+            code = (code & ~(uint64_t(3) << shift)) | (value << shift);
+        }
+    }
+}
+
+void Board::refreshThreats(int index) {
+    // Only empty cells within two steps along a line can see the change
+    for (int line = 0; line < LINE_COUNT; line++) {
+        int d = lineSteps[line];
+        for (int k = -2; k <= 2; k++) {
+            int cell = index + k * d;
+            bool empty = cells[cell] == static_cast<uint8_t>(CellState::EMPTY);
+            uint8_t sg = empty ? static_cast<uint8_t>(sosAt(cell, CellState::S)) : 0;
+            uint8_t og = empty ? static_cast<uint8_t>(sosAt(cell, CellState::O)) : 0;
+            sGains[cell] = sg;
+            oGains[cell] = og;
+
+            bool scoring = (sg | og) != 0;
+            int slot = scoringSlot[cell];
+            if (scoring && slot < 0) {
+                scoringSlot[cell] = static_cast<int>(scoringCells.size());
+                scoringCells.push_back(cell);
+            } else if (!scoring && slot >= 0) {
+                int last = scoringCells.back();
+                scoringCells[slot] = last;
+                scoringSlot[last] = slot;
+                scoringCells.pop_back();
+                scoringSlot[cell] = -1;
+            }
+        }
+    }
+}
+
+int Board::sosAt(int index, CellState placed) const {
+    if (!(tracking & TRACK_NEIGHBOURHOOD)) {
+        return soskernels::sosAt(cells.data(), index, placed, lineSteps);
+    }
+    uint64_t codes = neighbourhood[index];
+    uint64_t centre = static_cast<uint64_t>(placed) << 4;
+
+    // Setting the centre slot lets the same lookup score a letter that has
+    // not been placed yet
+    return SOS_TABLE[((codes >> 0) & 1023) | centre] +
+           SOS_TABLE[((codes >> 10) & 1023) | centre] +
+           SOS_TABLE[((codes >> 20) & 1023) | centre] +
+           SOS_TABLE[((codes >> 30) & 1023) | centre];
+}
+
+uint64_t Board::lineCodes(int index) const {
+    if (tracking & TRACK_NEIGHBOURHOOD) {
+        return neighbourhood[index];
+    }
+
+    // Same packing as updateNeighbourhood; frame cells read as BORDER,
+    // which matches nothing either
+    uint64_t codes = 0;
+    for (int line = 0; line < LINE_COUNT; line++) {
+        int d = lineSteps[line];
+        for (int k = -2; k <= 2; k++) {
+            codes |= static_cast<uint64_t>(cells[index + k * d]) << (10 * line + 2 * (k + 2));
+        }
+    }
+    return codes;
+}
+
+int Board::checkForSOS(int row, int col) const {
+    CellState placed = getCell(row, col);
+    if (placed == CellState::EMPTY) {
+        return 0;
+    }
+    return sosAt(index(row, col), placed);
+}
+
+int Board::checkForSOS(int row, int col, char letter) const {
+    // isEmpty() holds off the board too, where index() is unchecked
+    if (row < 0 || row >= size || col < 0 || col >= size) {
+        return 0;
+    }
+    if (!isEmpty(row, col) || (letter != 'S' && letter != 'O')) {
+        return 0;
+    }
+    return sosAt(index(row, col), letter == 'S' ? CellState::S : CellState::O);
+}
+
+int Board::findSOS(int row, int col, SOSLine* out, int capacity) const {
+    CellState placed = getCell(row, col);
+    if (placed == CellState::EMPTY) {
+        return 0;
+    }
+
+    // Row/col step of each line, matching lineSteps
+    static const int steps[LINE_COUNT][2] = {{0, 1}, {1, 0}, {1, 1}, {-1, 1}};
+    uint64_t codes = lineCodes(index(row, col));
+    int count = 0;
+
+    auto add = [&](int fromStep, int toStep, int line) {
+        if (count < capacity) {
+            out[count].startRow = row + fromStep * steps[line][0];
+            out[count].startCol = col + fromStep * steps[line][1];
+            out[count].endRow = row + toStep * steps[line][0];
+            out[count].endCol = col + toStep * steps[line][1];
+        }
+        count++;
+    };
+
+    for (int line = 0; line < LINE_COUNT; line++) {
+        uint64_t code = (codes >> (10 * line)) & 1023;
+        if (SOS_TABLE[code] == 0) {
+            continue;
+        }
+
+        // Slots 0-4 of the code are the cells at steps -2..2
+        if (placed == CellState::O) {
+            add(-1, 1, line);
+        } else {
+            if (SOS_TABLE[code & 0x3F] != 0) {
+                add(-2, 0, line);
+            }
+            if (SOS_TABLE[code & 0x3F0] != 0) {
+                add(0, 2, line);
+            }
+        }
+    }
+
+    return count;
+}
+
+void Board::buildViews(LineView* target) const {
+    // Rows and columns need size lines, the diagonals 2 * size - 1.
+    // Two extra zero bits at each end keep 5-bit windows inside the set.
+    int w = size + 2;
+    for (int line = 0; line < LINE_COUNT; line++) {
+        int lines = (line == HORIZONTAL || line == VERTICAL) ? size : 2 * size - 1;
+        target[line].s = Bitboard(4 + lines * w);
+        target[line].o = Bitboard(4 + lines * w);
+    }
+    for (int i = emptyTotal; i < size * size; i++) {
+        int row = emptyCells[i] / size;
+        int col = emptyCells[i] % size;
+        updateViews(target, row, col, cellAt(row, col), true);
+    }
+}
+
+void Board::updateViews(LineView* target, int row, int col, CellState letter, bool placed) const {
+    for (int line = 0; line < LINE_COUNT; line++) {
+        Bitboard& mask = letter == CellState::S ? target[line].s : target[line].o;
+        int pos = viewPos(static_cast<Line>(line), row, col);
+        if (placed) {
+            mask.set(pos);
+        } else {
+            mask.clear(pos);
+        }
+    }
+}
+
+int Board::countAllSOS() const {
+    // Building views for one count costs more than comparing the bytes
+    if (!(tracking & TRACK_LINE_VIEWS)) {
+        return soskernels::countFramedTriples(cells.data(), size, stride);
+    }
+
+    // A bit i starts an SOS when S is at i, O at i + 1 and S at i + 2.
+    // The zero gaps between lines stop matches from wrapping onto the next line.
+    int count = 0;
+    for (int line = 0; line < LINE_COUNT; line++) {
+        const Bitboard& s = views[line].s;
+        count += soskernels::countTriples(s.data(), views[line].o.data(), s.wordCount());
+    }
     return count;
 }
 
 // reset board
 void Board::reset() {
-    for (int i = 0; i < size; i++) {
-        for (int j = 0; j < size; j++) {
-            grid[i][j] = CellState::EMPTY;
+    // A lightly played board is cheaper to take back letter by letter than
+    // to refill; the occupied cells sit past the end of the empty set
+    int cellCount = size * size;
+    if ((cellCount - emptyTotal) * SPARSE_RESET_RATIO <= cellCount) {
+        while (emptyTotal < cellCount) {
+            int cell = emptyCells[emptyTotal];
+            unmakeMove(cell / size, cell % size);
         }
+        return;
+    }
+
+    for (int row = 0; row < size; row++) {
+        std::fill_n(cells.begin() + index(row, 0), size, static_cast<uint8_t>(CellState::EMPTY));
     }
+    fillEmptySet();
+    buildTracking();
+    std::fill(symKeys, symKeys + 8, zobrist::boardKey(size));
 }
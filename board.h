@@ -1,28 +1,255 @@
 #ifndef BOARD_H
 #define BOARD_H
 
+#include <cstdint>
+#include <random>
 #include <vector>
 #include "enums.h"
+#include "bitboard.h"
 
 class Board {
+public:
+    // The four lines an SOS can lie on
+    enum Line {
+        HORIZONTAL,
+        VERTICAL,
+        DIAGONAL,       // down-right
+        ANTI_DIAGONAL,  // up-right
+        LINE_COUNT
+    };
+
+    // Endpoints of one completed S-O-S
+    struct SOSLine {
+        int startRow;
+        int startCol;
+        int endRow;
+        int endCol;
+    };
+    // Most SOS one letter can complete: an S ends up to two on each line
+    static constexpr int MAX_SOS_PER_MOVE = 8;
+
+    // S and O masks for one line direction. Cells that are neighbours along
+    // the line are neighbouring bits, and lines are separated by two zero
+    // bits so a shifted mask never joins cells from different lines. The
+    // byte cells stay the per-cell store; views are a second copy of the
+    // position for whole-board counting, so they are opt-in.
+    struct LineView {
+        Bitboard s;
+        Bitboard o;
+    };
+
+    // Optional tables a Board can keep on top of its cells, empty set and
+    // hash. Each costs memory per cell and work on every move, so a plain
+    // Board keeps none and callers opt in to the ones they read.
+    enum Tracking : unsigned {
+        TRACK_NONE = 0,
+        TRACK_LINE_VIEWS = 1 << 0,     // per-line bitboards kept for countAllSOS
+        TRACK_NEIGHBOURHOOD = 1 << 1,  // line codes: scoring is 4 table lookups
+        TRACK_THREATS = 1 << 2,        // sGain / oGain and the scoring-cell set
+        TRACK_TRIPLES = 1 << 3,        // triple table, setup counts, safe cells
+        TRACK_SYMMETRY = 1 << 4,       // hashes of the 7 other symmetric images
+        // Everything the greedy engine and the search read
+        TRACK_ENGINE = TRACK_NEIGHBOURHOOD | TRACK_THREATS | TRACK_TRIPLES
+    };
+
 private:
     int size;
-    std::vector<std::vector<CellState>> grid;
+    unsigned tracking;
+    int stride;                  // cells per row in the flat buffer, size + 4
+    std::vector<uint8_t> cells;  // row-major, one byte per cell, 2-cell BORDER frame
+    int lineSteps[LINE_COUNT];   // buffer offset to the next cell along each line
+
+    // Neighbourhood code per buffer cell (TRACK_NEIGHBOURHOOD): for each
+    // line, the 5 cells centred on it at 2 bits each (CellState values),
+    // line L in bits 10L..10L+9. Kept in step by makeMove/unmakeMove so
+    // scoring is 4 table lookups; untracked boards scan the cells instead.
+    std::vector<uint64_t> neighbourhood;
+
+    LineView views[LINE_COUNT];      // TRACK_LINE_VIEWS, empty otherwise
+
+    // Empty cells as an indexed set: the first emptyTotal entries of
+    // emptyCells are row * size + col for every empty cell in no particular
+    // order, and the rest are the occupied cells, so reset() can find the
+    // placed letters without a scan. emptySlot maps a cell back to its
+    // position; removal swaps it with the last empty entry.
+    std::vector<int> emptyCells;
+    std::vector<int> emptySlot;
+    int emptyTotal;
+
+    // Zobrist hash of the cells under each of the 8 symmetries, updated by
+    // makeMove; index 0 is the identity, i.e. hash(), and is always kept.
+    // The other 7 cost a transform each per move (TRACK_SYMMETRY).
+    uint64_t symKeys[8];
+
+    // Threat map per buffer cell (TRACK_THREATS): SOS an S or an O would
+    // complete there (0 for occupied and frame cells). Cells with any gain
+    // are kept in an indexed set of buffer indices, like the empty set.
+    std::vector<uint8_t> sGains;
+    std::vector<uint8_t> oGains;
+    std::vector<int> scoringCells;
+    std::vector<int> scoringSlot;
+
+    // Triple table (TRACK_TRIPLES): one state byte per (line, start cell)
+    // for the S-O-S starting at that buffer cell and running along the
+    // line. Bits 0-1 count letters placed that fit the pattern, bits 2-5
+    // letters that don't; triples leaving the board start with a misfit
+    // count of 8 so they are never live. Aggregates are kept in step with
+    // the table.
+    std::vector<uint8_t> triples;
+    std::vector<uint8_t> cellLive;   // live triples covering each buffer cell
+    int liveTriples;
+    int nearTriples;                 // live with two letters placed
+    int completedTriples;
+
+    // Setups per buffer cell (TRACK_TRIPLES): live triples holding exactly
+    // one fitting letter in which this cell's slot wants an S (sSetupCounts)
+    // or an O. Placing that letter on an empty cell hands the opponent a
+    // scoring move. Empty cells where some letter sets nothing up are kept
+    // in an indexed set of buffer indices, like the scoring cells.
+    std::vector<uint8_t> sSetupCounts;
+    std::vector<uint8_t> oSetupCounts;
+    std::vector<int> safeCells;
+    std::vector<int> safeSlot;
+
+    // Sizes the enabled tables, frees the others and replays the placed
+    // letters into them
+    void buildTracking();
+    // Sizes 'target' for this board and sets the bits of the placed letters
+    void buildViews(LineView* target) const;
+    void updateViews(LineView* target, int row, int col, CellState letter, bool placed) const;
+    void initTriples();
+    void updateTriples(int index, CellState letter, int delta);
+
+    void toggleKeys(int row, int col, CellState letter);
+    void toggleSymmetricKeys(int row, int col, CellState letter);
+    void updateNeighbourhood(int index, CellState letter);
+    void refreshThreats(int index);
+
+    void fillEmptySet();
+    void removeEmpty(int cell);
+    void addEmpty(int cell);
+    void swapEmptySlots(int a, int b);
+    void refreshSafe(int index);
+
+    // reset() unmakes the placed letters one by one while they are at most
+    // 1 / SPARSE_RESET_RATIO of the board, and refills every table above that
+    static constexpr int SPARSE_RESET_RATIO = 16;
 
     bool checkSOSAt(int row, int col, int dRow, int dCol) const;
+    int sosAt(int index, CellState placed) const;
+    // Neighbourhood code of a cell, from the table or read off the cells
+    uint64_t lineCodes(int index) const;
 
 public:
-    Board(int boardSize = 8);
+    // Value of the frame cells around the board; never equal to S or O, so
+    // neighbour reads up to two cells out need no bounds checks
+    static constexpr uint8_t BORDER = 3;
+
+    Board(int boardSize = 8, unsigned trackingFlags = TRACK_NONE);
 
     // Validation: board size must be > 2
     bool isValidSize(int size) const;
     int getSize() const;
+
+    unsigned getTracking() const { return tracking; }
+    bool tracks(unsigned flags) const { return (tracking & flags) == flags; }
+    // Switches tables on or off; newly enabled ones are built from the
+    // current position in O(cells)
+    void setTracking(unsigned trackingFlags);
     CellState getCell(int row, int col) const;
     bool isEmpty(int row, int col) const;
     bool isFull() const;
+    int emptyCount() const { return emptyTotal; }
+    // i-th cell of the empty set, 0 <= i < emptyCount()
+    void emptyCellAt(int i, int& row, int& col) const {
+        row = emptyCells[i] / size;
+        col = emptyCells[i] % size;
+    }
+    // Draws from the caller's generator, so engines on other threads never
+    // share one
+    bool randomEmptyCell(int& row, int& col, std::mt19937& rng) const;
+
+    // Unchecked access for hot loops. Cells up to two outside the board read
+    // as BORDER; anything further is out of the buffer.
+    int index(int row, int col) const { return (row + 2) * stride + col + 2; }
+    CellState cellAt(int row, int col) const {
+        return static_cast<CellState>(cells[index(row, col)]);
+    }
+    const uint8_t* data() const { return cells.data(); }
+    int getStride() const { return stride; }
+
+    // Bit position of a cell inside the given line view
+    int viewPos(Line line, int row, int col) const {
+        int w = size + 2;
+        switch (line) {
+        case HORIZONTAL:    return 2 + row * w + col;
+        case VERTICAL:      return 2 + col * w + row;
+        case DIAGONAL:      return 2 + (col - row + size - 1) * w + col;
+        default:            return 2 + (row + col) * w + col;
+        }
+    }
+    // TRACK_LINE_VIEWS only
+    const LineView& getView(Line line) const { return views[line]; }
 
     bool makeMove(int row, int col, char letter);
+    // Inverse of makeMove: empties an occupied cell
+    bool unmakeMove(int row, int col);
     int checkForSOS(int row, int col) const;
+    // SOS count that placing 'letter' on the (empty) cell would complete
+    int checkForSOS(int row, int col, char letter) const;
+    // Same count as checkForSOS, also writing the endpoints of up to
+    // 'capacity' completed lines to 'out'
+    int findSOS(int row, int col, SOSLine* out, int capacity) const;
+    // Whole-board count through the SIMD kernels: over the line views with
+    // TRACK_LINE_VIEWS, otherwise straight over the cell bytes
+    int countAllSOS() const;
+
+    // Incrementally maintained threat map (TRACK_THREATS only); both are 0
+    // on occupied cells
+    int sGain(int row, int col) const { return sGains[index(row, col)]; }
+    int oGain(int row, int col) const { return oGains[index(row, col)]; }
+    // Empty cells where at least one letter scores, in no particular order
+    int scoringMoveCount() const { return static_cast<int>(scoringCells.size()); }
+    void scoringCellAt(int i, int& row, int& col) const {
+        row = scoringCells[i] / stride - 2;
+        col = scoringCells[i] % stride - 2;
+    }
+
+    // Triple table statistics (TRACK_TRIPLES only). A triple is one of the
+    // S-O-S placements on the board: dead once it holds a wrong letter,
+    // completed when it reads S-O-S, live otherwise.
+    int liveTripleCount() const { return liveTriples; }
+    int nearCompleteTripleCount() const { return nearTriples; }
+    int completedTripleCount() const { return completedTriples; }
+    int liveTriplesAt(int row, int col) const { return cellLive[index(row, col)]; }
+
+    // Triples that placing an S / an O on the cell would leave one letter
+    // short of S-O-S, i.e. new scoring moves it would give the opponent
+    // (TRACK_TRIPLES only)
+    int sSetups(int row, int col) const { return sSetupCounts[index(row, col)]; }
+    int oSetups(int row, int col) const { return oSetupCounts[index(row, col)]; }
+    // Empty cells where at least one letter has no setups, in no particular order
+    int safeMoveCount() const { return static_cast<int>(safeCells.size()); }
+    void safeCellAt(int i, int& row, int& col) const {
+        row = safeCells[i] / stride - 2;
+        col = safeCells[i] % stride - 2;
+    }
+
+    uint64_t hash() const { return symKeys[0]; }
+
+    // Symmetries of the square: 0 identity, 1-3 rotations by 90/180/270
+    // degrees clockwise, 4 mirror left-right, 5 mirror top-bottom,
+    // 6 transpose, 7 anti-transpose
+    static void transformCell(int symmetry, int size, int row, int col, int& outRow, int& outCol);
+    static int inverseSymmetry(int symmetry);
+
+    // Smallest hash over the 8 symmetric images of the position, and the
+    // symmetry that produces it (TRACK_SYMMETRY only)
+    uint64_t canonicalKey() const;
+    int canonicalSymmetry() const;
+    // Map a cell between this position and its canonical image
+    void toCanonical(int row, int col, int& outRow, int& outCol) const;
+    void fromCanonical(int row, int col, int& outRow, int& outCol) const;
     void reset();
 };
 
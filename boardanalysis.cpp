@@ -0,0 +1,79 @@
+#include "boardanalysis.h"
+#include "soskernels.h"
+#include <algorithm>
+
+BoardAnalysis::BoardAnalysis()
+    : sosCount(0), emptyCells(0), scoringCells(0), sGainTotal(0), oGainTotal(0) {}
+
+BoardAnalysis& BoardAnalysis::operator+=(const BoardAnalysis& other) {
+    sosCount += other.sosCount;
+    emptyCells += other.emptyCells;
+    scoringCells += other.scoringCells;
+    sGainTotal += other.sGainTotal;
+    oGainTotal += other.oGainTotal;
+    return *this;
+}
+
+BoardAnalysis analyzeRows(const Board& board, int firstRow, int lastRow) {
+    const uint8_t* cells = board.data();
+    const uint8_t S = static_cast<uint8_t>(CellState::S);
+    const uint8_t O = static_cast<uint8_t>(CellState::O);
+    const uint8_t EMPTY = static_cast<uint8_t>(CellState::EMPTY);
+
+    // Right, down, down-right, down-left: every SOS is counted once, from
+    // its top (or left) end. The BORDER frame makes all reads safe.
+    int stride = board.getStride();
+    const int forward[4] = {1, stride, stride + 1, stride - 1};
+    const int lines[4] = {1, stride, stride + 1, 1 - stride};
+
+    BoardAnalysis result;
+    int size = board.getSize();
+    for (int row = firstRow; row < lastRow; row++) {
+        int index = board.index(row, 0);
+        for (int col = 0; col < size; col++, index++) {
+            const uint8_t* c = cells + index;
+            for (int d : forward) {
+                result.sosCount += (c[0] == S) & (c[d] == O) & (c[2 * d] == S);
+            }
+
+            if (c[0] == EMPTY) {
+                int sGain = soskernels::sosAt(cells, index, CellState::S, lines);
+                int oGain = soskernels::sosAt(cells, index, CellState::O, lines);
+                result.emptyCells++;
+                result.sGainTotal += sGain;
+                result.oGainTotal += oGain;
+                result.scoringCells += (sGain + oGain) > 0;
+            }
+        }
+    }
+
+    return result;
+}
+
+BoardAnalysis analyzeBoard(const Board& board) {
+    return analyzeRows(board, 0, board.getSize());
+}
+
+BoardAnalysis analyzeBoard(const Board& board, ThreadPool& pool) {
+    int size = board.getSize();
+
+    // A few bands per thread evens out the load; each band needs only its
+    // own rows plus the two-row halo on either side
+    int bands = std::min(size, pool.threadCount() * 4);
+    std::vector<BoardAnalysis> partial(bands);
+
+    for (int band = 0; band < bands; band++) {
+        int firstRow = static_cast<int>(static_cast<long long>(size) * band / bands);
+        int lastRow = static_cast<int>(static_cast<long long>(size) * (band + 1) / bands);
+        pool.submit([&board, &partial, band, firstRow, lastRow] {
+            partial[band] = analyzeRows(board, firstRow, lastRow);
+        });
+    }
+    pool.wait();
+
+    BoardAnalysis total;
+    for (const BoardAnalysis& part : partial) {
+        total += part;
+    }
+    return total;
+}
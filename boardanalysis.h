@@ -0,0 +1,31 @@
+#ifndef BOARDANALYSIS_H
+#define BOARDANALYSIS_H
+
+#include "board.h"
+#include "threadpool.h"
+
+// Whole-board statistics recomputed from the cells alone, independent of
+// the incrementally maintained counters on Board, for validating large
+// recorded or generated positions.
+struct BoardAnalysis {
+    long long sosCount;      // completed S-O-S lines
+    long long emptyCells;
+    long long scoringCells;  // empty cells where an S or an O would score
+    long long sGainTotal;    // SOS an S would complete, summed over empty cells
+    long long oGainTotal;
+
+    BoardAnalysis();
+    BoardAnalysis& operator+=(const BoardAnalysis& other);
+};
+
+// Rows [firstRow, lastRow) only. Reads up to two rows either side (the
+// halo), so bands can be analysed independently and summed.
+BoardAnalysis analyzeRows(const Board& board, int firstRow, int lastRow);
+
+// Single-threaded pass over the whole board
+BoardAnalysis analyzeBoard(const Board& board);
+
+// Splits the board into row bands, analyses them on the pool and reduces
+BoardAnalysis analyzeBoard(const Board& board, ThreadPool& pool);
+
+#endif // BOARDANALYSIS_H
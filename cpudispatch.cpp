@@ -0,0 +1,95 @@
+#include "cpudispatch.h"
+#include <cstdlib>
+#include <cstring>
+
+#if defined(SOS_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+SimdLevel detect() {
+#if defined(SOS_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) {
+        return SimdLevel::SSE42;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SimdLevel::SSE2;
+    }
+    return SimdLevel::SCALAR;
+#elif defined(SOS_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool sse2 = (info[3] >> 26) & 1;
+    bool sse42 = ((info[2] >> 20) & 1) && ((info[2] >> 23) & 1);
+    bool osxsave = (info[2] >> 27) & 1;
+
+    // AVX state must also be enabled by the OS (XCR0)
+    bool avxState = false;
+    bool avx512State = false;
+    if (osxsave) {
+        unsigned long long xcr0 = _xgetbv(0);
+        avxState = (xcr0 & 0x6) == 0x6;
+        avx512State = (xcr0 & 0xE6) == 0xE6;
+    }
+
+    __cpuidex(info, 7, 0);
+    bool avx2 = avxState && ((info[1] >> 5) & 1);
+    bool avx512 = avx512State && ((info[1] >> 16) & 1) && ((info[1] >> 30) & 1);
+
+    if (avx512) return SimdLevel::AVX512;
+    if (avx2) return SimdLevel::AVX2;
+    if (sse42) return SimdLevel::SSE42;
+    if (sse2) return SimdLevel::SSE2;
+    return SimdLevel::SCALAR;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+}
+
+SimdLevel detectedSimdLevel() {
+    static const SimdLevel level = detect();
+    return level;
+}
+
+SimdLevel activeSimdLevel() {
+    static const SimdLevel level = [] {
+        SimdLevel detected = detectedSimdLevel();
+        SimdLevel forced;
+        const char* env = std::getenv("SOS_SIMD_LEVEL");
+        if (env && parseSimdLevel(env, forced) && forced < detected) {
+            return forced;
+        }
+        return detected;
+    }();
+    return level;
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::SCALAR: return "scalar";
+    case SimdLevel::SSE2:   return "sse2";
+    case SimdLevel::SSE42:  return "sse4.2";
+    case SimdLevel::AVX2:   return "avx2";
+    default:                return "avx512";
+    }
+}
+
+bool parseSimdLevel(const char* name, SimdLevel& level) {
+    const SimdLevel all[] = {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::SSE42,
+                             SimdLevel::AVX2, SimdLevel::AVX512};
+    for (SimdLevel candidate : all) {
+        if (std::strcmp(name, simdLevelName(candidate)) == 0) {
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,38 @@
+#ifndef CPUDISPATCH_H
+#define CPUDISPATCH_H
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SOS_X86 1
+#endif
+
+// Function attribute that lets GCC/Clang compile one function for a wider
+// instruction set than the rest of the build; MSVC needs nothing
+#if defined(SOS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SOS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SOS_TARGET(isa)
+#endif
+
+// Instruction set levels the board kernels are built for, in order
+enum class SimdLevel {
+    SCALAR,
+    SSE2,
+    SSE42,   // SSE4.2 generation, used for hardware POPCNT
+    AVX2,
+    AVX512   // AVX-512 F + BW
+};
+
+// Best level this CPU supports, detected on first use
+SimdLevel detectedSimdLevel();
+
+// Level the kernels run at: the detected level, lowered by the
+// SOS_SIMD_LEVEL environment variable (scalar, sse2, sse4.2, avx2,
+// avx512) when it is set. The override never raises the level above
+// what the CPU supports. Fixed for the lifetime of the process.
+SimdLevel activeSimdLevel();
+
+const char* simdLevelName(SimdLevel level);
+// Parses the SOS_SIMD_LEVEL spellings; returns false if unrecognised
+bool parseSimdLevel(const char* name, SimdLevel& level);
+
+#endif // CPUDISPATCH_H
@@ -0,0 +1,78 @@
+#include "engine.h"
+
+namespace {
+// Empty cells sampled when every move sets something up
+const int FALLBACK_SAMPLES = 16;
+
+// Keeps the best-scoring candidate, replacing ties with probability
+// 1 / ties so each tied candidate is equally likely to survive
+struct Best {
+    EngineMove move;
+    int score;
+    int ties;
+    std::mt19937& rng;
+
+    explicit Best(std::mt19937& random) : move{-1, -1, 'S'}, score(0), ties(0), rng(random) {}
+
+    void offer(int row, int col, char letter, int candidateScore) {
+        if (ties == 0 || candidateScore > score) {
+            score = candidateScore;
+            ties = 1;
+            move = {row, col, letter};
+        } else if (candidateScore == score && rng() % ++ties == 0) {
+            move = {row, col, letter};
+        }
+    }
+};
+}
+
+bool chooseGreedyMove(const Board& board, std::mt19937& rng, EngineMove& move) {
+    if (board.isFull()) {
+        return false;
+    }
+    // The engine reads the threat map and setup counts; a board without
+    // them is looked at through a tracked copy, at O(cells) per call
+    if (!board.tracks(Board::TRACK_THREATS | Board::TRACK_TRIPLES)) {
+        Board tracked = board;
+        tracked.setTracking(Board::TRACK_ENGINE);
+        return chooseGreedyMove(tracked, rng, move);
+    }
+
+    // Scoring moves: most SOS first, then fewest setups
+    Best best(rng);
+    for (int i = 0; i < board.scoringMoveCount(); i++) {
+        int row, col;
+        board.scoringCellAt(i, row, col);
+        if (board.sGain(row, col) > 0) {
+            best.offer(row, col, 'S', board.sGain(row, col) * 64 - board.sSetups(row, col));
+        }
+        if (board.oGain(row, col) > 0) {
+            best.offer(row, col, 'O', board.oGain(row, col) * 64 - board.oSetups(row, col));
+        }
+    }
+    if (best.ties > 0) {
+        move = best.move;
+        return true;
+    }
+
+    // No SOS to take: any safe cell, with a letter that keeps it safe
+    if (board.safeMoveCount() > 0) {
+        int row, col;
+        board.safeCellAt(static_cast<int>(rng() % board.safeMoveCount()), row, col);
+        bool sSafe = board.sSetups(row, col) == 0;
+        bool oSafe = board.oSetups(row, col) == 0;
+        char letter = (sSafe && oSafe) ? ((rng() % 2) ? 'S' : 'O') : (sSafe ? 'S' : 'O');
+        move = {row, col, letter};
+        return true;
+    }
+
+    // Every move gives something away; limit the damage over a sample
+    for (int i = 0; i < FALLBACK_SAMPLES; i++) {
+        int row, col;
+        board.randomEmptyCell(row, col, rng);
+        best.offer(row, col, 'S', -board.sSetups(row, col));
+        best.offer(row, col, 'O', -board.oSetups(row, col));
+    }
+    move = best.move;
+    return true;
+}
@@ -0,0 +1,23 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "board.h"
+
+// A move chosen by a computer player
+struct EngineMove {
+    int row;
+    int col;
+    char letter;  // 'S' or 'O'
+};
+
+// One-ply greedy player, driven by the threat map and setup counts Board
+// keeps up to date (Board::TRACK_ENGINE), so a choice costs O(scoring
+// cells) rather than a scan:
+//   1. the move completing the most SOS, preferring ones that set nothing up
+//   2. otherwise a random safe move, one that gives the opponent no SOS
+//   3. otherwise, of a few random empty cells, the letter setting up least
+// Ties are broken with the caller's generator. Returns false on a full
+// board.
+bool chooseGreedyMove(const Board& board, std::mt19937& rng, EngineMove& move);
+
+#endif // ENGINE_H
@@ -1,7 +1,9 @@
 #ifndef ENUMS_H
 #define ENUMS_H
 
-enum class CellState {
+#include <cstdint>
+
+enum class CellState : uint8_t {
     EMPTY,
     S,
     O
@@ -17,6 +19,12 @@ enum class GameMode {
     GENERAL  // Most SOS sequences wins
 };
 
+enum class ComputerEngine {
+    GREEDY,  // One-ply threat-aware choice
+    SEARCH,  // Alpha-beta search within the game's search limits
+    MCTS     // Monte Carlo tree search within the game's MCTS limits
+};
+
 enum class GameState {
     ONGOING,
     PLAYER1_WIN,
@@ -1,9 +1,22 @@
 #include "game.h"
+#include "engine.h"
+#include "zobrist.h"
 #include <cstdlib>
 
+namespace {
+// Node budget per computer move until setSearchLimits says otherwise:
+// a few milliseconds, so scripted and test games stay quick
+const long long DEFAULT_SEARCH_NODES = 20000;
+// Likewise for MCTS, in playouts
+const long long DEFAULT_MCTS_PLAYOUTS = 2000;
+}
+
 Game::Game(int size, GameMode gameMode)
-    : board(size), mode(gameMode), state(GameState::ONGOING), boardSize(size),
-      recording(false), moveCounter(0) {
+    : board(size), mode(gameMode),
+      state(GameState::ONGOING), boardSize(size), recording(false), moveCounter(0),
+      engine(ComputerEngine::SEARCH), greedyRng(static_cast<unsigned>(rand())),
+      searchLimits{0, 0, DEFAULT_SEARCH_NODES},
+      mctsLimits{0, DEFAULT_MCTS_PLAYOUTS, 0, 1} {
 
     player1 = std::make_unique<Player>("Player 1", PlayerType::HUMAN);
     player2 = std::make_unique<Player>("Player 2", PlayerType::HUMAN);
@@ -15,6 +28,7 @@ void Game::setupPlayers(const std::string& p1Name, PlayerType p1Type,
     player1 = std::make_unique<Player>(p1Name, p1Type);
     player2 = std::make_unique<Player>(p2Name, p2Type);
     currentPlayer = player1.get();
+    undoStack.clear();
 }
 
 bool Game::makeMove(int row, int col) {
@@ -24,6 +38,15 @@ bool Game::makeMove(int row, int col) {
         return false;
     }
 
+    UndoRecord undo;
+    undo.row = row;
+    undo.col = col;
+    undo.letter = letter;
+    undo.points = 0;
+    undo.player2Moved = (currentPlayer == player2.get());
+    undo.recorded = recording;
+    undo.prevState = state;
+
     if (recording) {
         moveCounter++;
         MoveRecord record;
@@ -37,6 +60,8 @@ bool Game::makeMove(int row, int col) {
 
     // Check for SOS formations
     int sosCount = board.checkForSOS(row, col);
+    undo.points = static_cast<uint8_t>(sosCount);
+    undoStack.push_back(undo);
 
     if (sosCount > 0) {
         currentPlayer->addScore(sosCount);
@@ -61,41 +86,107 @@ bool Game::makeMove(int row, int col) {
     return true;
 }
 
+bool Game::unmakeMove() {
+    if (undoStack.empty()) {
+        return false;
+    }
+
+    const UndoRecord& undo = undoStack.back();
+    board.unmakeMove(undo.row, undo.col);
+
+    currentPlayer = undo.player2Moved ? player2.get() : player1.get();
+    currentPlayer->setCurrentLetter(undo.letter);
+    currentPlayer->subtractScore(undo.points);
+    state = undo.prevState;
+
+    if (undo.recorded && !recordedMoves.empty()) {
+        recordedMoves.pop_back();
+        moveCounter--;
+    }
+
+    undoStack.pop_back();
+    return true;
+}
+
 bool Game::makeComputerMove(){
     int row, col;
     return makeComputerMove(row, col);
 }
 
 bool Game::makeComputerMove(int& outRow, int& outCol){
+    EngineMove move;
+    if (!chooseComputerMove(move)) {
+        return false;
+    }
+    outRow = move.row;
+    outCol = move.col;
+    return playComputerMove(move);
+}
+
+bool Game::chooseComputerMove(EngineMove& move){
     if(state != GameState::ONGOING){
         return false;
     }
 
-    // Get all empty cells
-    std::vector<std::pair<int, int>> emptyCells;
-    for (int i = 0; i < board.getSize(); i++) {
-        for (int j = 0; j < board.getSize(); j++) {
-            if (board.isEmpty(i, j)) {
-                emptyCells.push_back(std::make_pair(i, j));
-            }
+    if (engine == ComputerEngine::SEARCH) {
+        SearchResult result;
+        if (!searchEngine.search(board, mode, searchLimits, result)) {
+            return false;
+        }
+        move = result.move;
+    } else if (engine == ComputerEngine::MCTS) {
+        Player* other = currentPlayer == player1.get() ? player2.get() : player1.get();
+        MctsResult result;
+        if (!mctsEngine.search(board, mode, currentPlayer->getScore() - other->getScore(),
+                               mctsLimits, result)) {
+            return false;
         }
+        move = result.move;
+    } else if (!chooseGreedyMove(board, greedyRng, move)) {
+        return false;
     }
+    return true;
+}
 
-    if (emptyCells.empty()) {
+bool Game::playComputerMove(const EngineMove& move){
+    if(state != GameState::ONGOING){
         return false;
     }
+    currentPlayer->setCurrentLetter(move.letter);
 
-    // Choose random empty cell
-    int randomIndex = rand() % emptyCells.size();
-    outRow = emptyCells[randomIndex].first;
-    outCol = emptyCells[randomIndex].second;
+    // Make the move
+    return makeMove(move.row, move.col);
+}
 
-    // Choose random letter
-    char letter = currentPlayer->chooseRandomLetter();
-    currentPlayer->setCurrentLetter(letter);
+void Game::setComputerEngine(ComputerEngine computerEngine) {
+    engine = computerEngine;
+    // Only the greedy engine reads the game's own board tables; the others
+    // search copies that set up their own
+    board.setTracking(engine == ComputerEngine::GREEDY ? Board::TRACK_ENGINE : Board::TRACK_NONE);
+}
 
-    // Make the move
-    return makeMove(outRow, outCol);
+ComputerEngine Game::getComputerEngine() const {
+    return engine;
+}
+
+void Game::setSearchLimits(const SearchLimits& limits) {
+    searchLimits = limits;
+}
+
+const SearchLimits& Game::getSearchLimits() const {
+    return searchLimits;
+}
+
+void Game::setSearchTableSize(int megabytes) {
+    searchEngine.setTableSize(megabytes);
+}
+
+void Game::setMctsLimits(const MctsLimits& limits) {
+    mctsLimits = limits;
+}
+
+const MctsLimits& Game::getMctsLimits() const {
+    return mctsLimits;
 }
 
 void Game::switchPlayer() {
@@ -156,12 +247,24 @@ GameState Game::getState() const {
     return state;
 }
 
+uint64_t Game::positionKey() const {
+    uint64_t key = board.hash();
+    if (currentPlayer == player2.get()) {
+        key ^= zobrist::SIDE_KEY;
+    }
+    if (mode == GameMode::GENERAL) {
+        key ^= zobrist::GENERAL_KEY;
+    }
+    return key;
+}
+
 void Game::reset() {
     board.reset();
     player1->resetScore();
     player2->resetScore();
     currentPlayer = player1.get();
     state = GameState::ONGOING;
+    undoStack.clear();
 }
 
 void Game::newGame(int size, GameMode gameMode) {
@@ -172,7 +275,12 @@ void Game::newGame(int size, GameMode gameMode) {
 
     boardSize = size;
     mode = gameMode;
-    board = Board(size);
+    // Same size: clear the board in place and keep its buffers
+    if (board.getSize() == size) {
+        board.reset();
+    } else {
+        board = Board(size, board.getTracking());
+    }
     player1->resetScore();
     player2->resetScore();
     currentPlayer = player1.get();
@@ -181,6 +289,8 @@ void Game::newGame(int size, GameMode gameMode) {
     recording = false;
     recordedMoves.clear();
     moveCounter = 0;
+    undoStack.clear();
+    searchEngine.clearTable();
 }
 
 void Game::startRecording() {
@@ -2,12 +2,15 @@
 #define GAME_H
 
 #include <memory>
+#include <random>
 #include <vector>
 #include <string>
 
 #include "enums.h"
 #include "board.h"
 #include "player.h"
+#include "search.h"
+#include "mcts.h"
 
 class Game {
 public:
@@ -20,6 +23,17 @@ public:
     };
 
 private:
+    // What makeMove changed, so unmakeMove can put it back
+    struct UndoRecord {
+        int row;
+        int col;
+        char letter;          // the mover's letter, given back on undo
+        uint8_t points;       // SOS completed by the move
+        bool player2Moved;
+        bool recorded;
+        GameState prevState;
+    };
+
     Board board;
     std::unique_ptr<Player> player1;
     std::unique_ptr<Player> player2;
@@ -31,6 +45,17 @@ private:
     bool recording;
     std::vector<MoveRecord> recordedMoves;
     int moveCounter;
+
+    std::vector<UndoRecord> undoStack;
+
+    ComputerEngine engine;
+    // The greedy engine's generator, used only by whichever thread is
+    // choosing the computer's move
+    std::mt19937 greedyRng;
+    SearchLimits searchLimits;
+    SearchEngine searchEngine;
+    MctsLimits mctsLimits;
+    MctsEngine mctsEngine;
 public:
     Game(int size = 8, GameMode gameMode = GameMode::SIMPLE);
 
@@ -38,8 +63,23 @@ public:
                       const std::string& p2Name, PlayerType p2Type);
 
     bool makeMove(int row, int col);
+    // Takes back the last move made through makeMove
+    bool unmakeMove();
     bool makeComputerMove();
     bool makeComputerMove(int& outRow, int& outCol);
+    // The two halves of makeComputerMove. chooseComputerMove only reads the
+    // game, so it can run on a worker thread while nothing else touches the
+    // game; playComputerMove then plays the choice for the current player.
+    bool chooseComputerMove(EngineMove& move);
+    bool playComputerMove(const EngineMove& move);
+    void setComputerEngine(ComputerEngine computerEngine);
+    ComputerEngine getComputerEngine() const;
+    void setSearchLimits(const SearchLimits& limits);
+    const SearchLimits& getSearchLimits() const;
+    // Transposition table memory for the search engine, in MB
+    void setSearchTableSize(int megabytes);
+    void setMctsLimits(const MctsLimits& limits);
+    const MctsLimits& getMctsLimits() const;
     void switchPlayer();
     void checkGameEnd();
 
@@ -50,6 +90,8 @@ public:
     Player* getPlayer2() const;
     GameMode getMode() const;
     GameState getState() const;
+    // Board hash combined with the side to move and the game mode
+    uint64_t positionKey() const;
 
     void reset();
     void newGame(int size, GameMode gameMode);
@@ -0,0 +1,189 @@
+#ifndef LAYOUTBOARD_H
+#define LAYOUTBOARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "enums.h"
+#include "board.h"
+
+// Cell placement policies for LayoutBoard. Each one maps a framed
+// coordinate (the board plus Board's 2-cell frame, 0 .. side - 1 on both
+// axes) to a byte offset in the cell buffer. All three are separable, the
+// offset being rowOffset(row) + colOffset(col), which lets LayoutBoard
+// keep both halves in small tables and pay two loads and an add per cell.
+
+// Row-major, the order Board itself uses. Cells two rows apart are
+// 2 * side bytes apart, so on large boards each row of a move's 5x5
+// neighbourhood is its own cache line and often its own page.
+class RowMajorLayout {
+    size_t side;
+
+public:
+    explicit RowMajorLayout(int framedSide) : side(framedSide) {}
+
+    size_t cellCount() const { return side * side; }
+    size_t rowOffset(int row) const { return row * side; }
+    size_t colOffset(int col) const { return col; }
+};
+
+// Square 8x8 tiles, one byte per cell, so a tile is exactly one 64-byte
+// cache line. Tiles are row-major, and so are the cells inside a tile.
+class TiledLayout {
+public:
+    static constexpr int TILE_BITS = 3;
+    static constexpr int TILE = 1 << TILE_BITS;
+
+private:
+    size_t tilesPerRow;
+
+public:
+    explicit TiledLayout(int framedSide) : tilesPerRow((framedSide + TILE - 1) / TILE) {}
+
+    size_t cellCount() const { return tilesPerRow * tilesPerRow * TILE * TILE; }
+    size_t rowOffset(int row) const {
+        return ((row >> TILE_BITS) * tilesPerRow << (2 * TILE_BITS)) | ((row & (TILE - 1)) << TILE_BITS);
+    }
+    size_t colOffset(int col) const {
+        return (static_cast<size_t>(col >> TILE_BITS) << (2 * TILE_BITS)) | (col & (TILE - 1));
+    }
+};
+
+// Z-order (Morton) curve: row and column bits interleaved, column in the
+// even bits. Every aligned 8x8 block is one cache line and every aligned
+// 64x64 block one 4 KiB page. The grid is padded to a power-of-two side,
+// which costs up to 4x the memory of the other layouts.
+class MortonLayout {
+    size_t side;
+
+    // Moves bit i of v to bit 2i
+    static uint64_t spread(uint32_t v) {
+        uint64_t x = v;
+        x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+        x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+        x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        x = (x | (x << 2)) & 0x3333333333333333ULL;
+        x = (x | (x << 1)) & 0x5555555555555555ULL;
+        return x;
+    }
+
+public:
+    explicit MortonLayout(int framedSide) : side(1) {
+        while (side < static_cast<size_t>(framedSide)) {
+            side <<= 1;
+        }
+    }
+
+    size_t cellCount() const { return side * side; }
+    size_t rowOffset(int row) const { return spread(row) << 1; }
+    size_t colOffset(int col) const { return spread(col); }
+};
+
+// Byte-per-cell board whose cell order is chosen by a layout policy, for
+// large boards where the row-major Board spreads each move's neighbourhood
+// over many cache lines. Same framing and CellState codes as Board, same
+// basic interface as PackedBoard; no line views or derived tables.
+template <typename Layout>
+class LayoutBoard {
+    int size;
+    Layout layout;
+    std::vector<size_t> rowOffsets;  // layout.rowOffset per framed row
+    std::vector<size_t> colOffsets;
+    std::vector<uint8_t> cells;
+    long long placed;
+
+    static constexpr uint8_t S = static_cast<uint8_t>(CellState::S);
+    static constexpr uint8_t O = static_cast<uint8_t>(CellState::O);
+
+    // Raw cell at a board coordinate; -2 .. size + 1 reaches the frame
+    uint8_t at(int row, int col) const { return cells[offsetOf(row, col)]; }
+
+    // SOS a letter at (row, col) would complete along step (dr, dc)
+    int sosAlong(int row, int col, int dr, int dc, CellState letter) const {
+        if (letter == CellState::S) {
+            return ((at(row - dr, col - dc) == O) & (at(row - 2 * dr, col - 2 * dc) == S)) +
+                   ((at(row + dr, col + dc) == O) & (at(row + 2 * dr, col + 2 * dc) == S));
+        }
+        return (at(row - dr, col - dc) == S) & (at(row + dr, col + dc) == S);
+    }
+
+    int sosAt(int row, int col, CellState letter) const {
+        return sosAlong(row, col, 0, 1, letter) + sosAlong(row, col, 1, 0, letter) +
+               sosAlong(row, col, 1, 1, letter) + sosAlong(row, col, -1, 1, letter);
+    }
+
+    bool inside(int row, int col) const {
+        return row >= 0 && row < size && col >= 0 && col < size;
+    }
+
+public:
+    LayoutBoard(int boardSize = 8)
+        : size(boardSize < 3 ? 3 : boardSize), layout(size + 4), placed(0) {
+        for (int i = 0; i < size + 4; i++) {
+            rowOffsets.push_back(layout.rowOffset(i));
+            colOffsets.push_back(layout.colOffset(i));
+        }
+        reset();
+    }
+
+    int getSize() const { return size; }
+
+    CellState getCell(int row, int col) const {
+        return inside(row, col) ? static_cast<CellState>(at(row, col)) : CellState::EMPTY;
+    }
+    bool isEmpty(int row, int col) const { return getCell(row, col) == CellState::EMPTY; }
+    bool isFull() const { return placed == static_cast<long long>(size) * size; }
+    long long emptyCount() const { return static_cast<long long>(size) * size - placed; }
+    size_t memoryBytes() const { return cells.size(); }
+
+    // Buffer offset of a board cell, for measuring how a layout spreads a
+    // neighbourhood over cache lines
+    size_t offsetOf(int row, int col) const { return rowOffsets[row + 2] + colOffsets[col + 2]; }
+
+    bool makeMove(int row, int col, char letter) {
+        if (!inside(row, col) || at(row, col) != static_cast<uint8_t>(CellState::EMPTY) ||
+            (letter != 'S' && letter != 'O')) {
+            return false;
+        }
+        cells[offsetOf(row, col)] = letter == 'S' ? S : O;
+        placed++;
+        return true;
+    }
+
+    bool unmakeMove(int row, int col) {
+        if (isEmpty(row, col)) {
+            return false;
+        }
+        cells[offsetOf(row, col)] = static_cast<uint8_t>(CellState::EMPTY);
+        placed--;
+        return true;
+    }
+
+    int checkForSOS(int row, int col) const {
+        CellState letter = getCell(row, col);
+        return letter == CellState::EMPTY ? 0 : sosAt(row, col, letter);
+    }
+
+    int checkForSOS(int row, int col, char letter) const {
+        if (!inside(row, col)) {
+            return 0;
+        }
+        if (!isEmpty(row, col) || (letter != 'S' && letter != 'O')) {
+            return 0;
+        }
+        return sosAt(row, col, letter == 'S' ? CellState::S : CellState::O);
+    }
+
+    void reset() {
+        // Padding the layout adds beyond the frame is BORDER too
+        cells.assign(layout.cellCount(), Board::BORDER);
+        for (int row = 0; row < size; row++) {
+            for (int col = 0; col < size; col++) {
+                cells[offsetOf(row, col)] = static_cast<uint8_t>(CellState::EMPTY);
+            }
+        }
+        placed = 0;
+    }
+};
+
+#endif // LAYOUTBOARD_H
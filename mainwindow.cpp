@@ -5,6 +5,14 @@
 #include <QGroupBox>
 #include <QPainter>
 #include <QPen>
+#include <QtConcurrent>
+#include <algorithm>
+#include <thread>
+
+// Of each one-second computer turn, the part spent searching for the move
+static const int COMPUTER_SEARCH_MS = 900;
+// From this size on, alpha-beta is too shallow and the computer uses MCTS
+static const int MCTS_MIN_SIZE = 8;
 
 // BoardWidget Implementation
 BoardWidget::BoardWidget(QWidget* parent) : QWidget(parent), boardButtons(nullptr), sosLines(nullptr) {}
@@ -52,13 +60,23 @@ void BoardWidget::paintEvent(QPaintEvent* event) {
 }
 
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), inReplayMode(false), replayIndex(0){
+    : QMainWindow(parent), computerTurn(0), inReplayMode(false), replayIndex(0){
 
     // Create the game
     game = new Game(8, GameMode::SIMPLE);
+    // The computer searches for most of its one-second turn
+    game->setSearchLimits({0, COMPUTER_SEARCH_MS, 0});
+    // MCTS shares its tree across all but one hardware thread, which is
+    // left to the window while the search runs in the background
+    int searchThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    game->setMctsLimits({COMPUTER_SEARCH_MS, 0, 0, searchThreads});
+    game->setComputerEngine(ComputerEngine::MCTS);
     computerMoveTimer = new QTimer(this);
     replayTimer = new QTimer(this);
     connect(computerMoveTimer, &QTimer::timeout, this, &MainWindow::makeComputerMove);
+    computerMoveWatcher = new QFutureWatcher<ComputerChoice>(this);
+    connect(computerMoveWatcher, &QFutureWatcher<ComputerChoice>::finished,
+            this, &MainWindow::computerMoveFinished);
     connect(replayTimer, &QTimer::timeout, this, &MainWindow::playNextReplayMove);
 
     QWidget* mainWidget = new QWidget(this);
@@ -177,6 +195,8 @@ MainWindow::MainWindow(QWidget *parent)
 }
 
 MainWindow::~MainWindow() {
+    // A search still running reads the game
+    computerMoveWatcher->waitForFinished();
     delete game;
     delete computerMoveTimer;
     delete replayTimer;
@@ -217,60 +237,18 @@ void MainWindow::createBoard() {
     boardWidget->update();
 }
 
-bool MainWindow::checkSOSLine(int r1, int c1, int r2, int c2, int r3, int c3) {
-    const Board& board = game->getBoard();
-    int size = board.getSize();
-
-    if (r1 < 0 || r1 >= size || c1 < 0 || c1 >= size ||
-        r2 < 0 || r2 >= size || c2 < 0 || c2 >= size ||
-        r3 < 0 || r3 >= size || c3 < 0 || c3 >= size) {
-        return false;
-    }
-
-    return (board.getCell(r1, c1) == CellState::S &&
-            board.getCell(r2, c2) == CellState::O &&
-            board.getCell(r3, c3) == CellState::S);
-}
-
 void MainWindow::checkAndDrawSOS(int row, int col, Player* scorer) {
     const Board& board = game->getBoard();
-    CellState placed = board.getCell(row, col);
 
     QColor lineColor = (scorer == game->getPlayer1()) ?
                            QColor(0, 100, 255) : QColor(255, 50, 50); // Blue for P1, Red for P2
 
-    // 8 directions
-    int directions[8][2] = {
-        {-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
-        {0, 1}, {1, -1}, {1, 0}, {1, 1}
-    };
-
-    if (placed == CellState::S) {
-        // Check if S is start of SOS
-        for (auto& dir : directions) {
-            int r2 = row + dir[0], c2 = col + dir[1];
-            int r3 = row + 2*dir[0], c3 = col + 2*dir[1];
-            if (checkSOSLine(row, col, r2, c2, r3, c3)) {
-                sosLines.push_back(std::make_tuple(row, col, r3, c3, lineColor));
-            }
-        }
-        // Check if S is end of SOS
-        for (auto& dir : directions) {
-            int r2 = row - dir[0], c2 = col - dir[1];
-            int r3 = row - 2*dir[0], c3 = col - 2*dir[1];
-            if (checkSOSLine(r3, c3, r2, c2, row, col)) {
-                sosLines.push_back(std::make_tuple(r3, c3, row, col, lineColor));
-            }
-        }
-    } else if (placed == CellState::O) {
-        // Check if O is middle of SOS
-        for (auto& dir : directions) {
-            int r1 = row - dir[0], c1 = col - dir[1];
-            int r3 = row + dir[0], c3 = col + dir[1];
-            if (checkSOSLine(r1, c1, row, col, r3, c3)) {
-                sosLines.push_back(std::make_tuple(r1, c1, r3, c3, lineColor));
-            }
-        }
+    // One scan of the placed cell's neighbourhood gives every completed line
+    Board::SOSLine found[Board::MAX_SOS_PER_MOVE];
+    int count = board.findSOS(row, col, found, Board::MAX_SOS_PER_MOVE);
+    for (int i = 0; i < count; i++) {
+        sosLines.push_back(std::make_tuple(found[i].startRow, found[i].startCol,
+                                           found[i].endRow, found[i].endCol, lineColor));
     }
 
     boardWidget->update();
@@ -380,6 +358,7 @@ void MainWindow::startNewGame() {
         inReplayMode = false;
         replayTimer->stop();
     }
+    cancelComputerTurn();
 
     GameMode mode = simpleButton->isChecked() ? GameMode::SIMPLE : GameMode::GENERAL;
 
@@ -390,6 +369,7 @@ void MainWindow::startNewGame() {
     // Start new game
     game->newGame(size, mode);
     game->setupPlayers("Player 1", p1Type, "Player 2", p2Type);
+    game->setComputerEngine(size >= MCTS_MIN_SIZE ? ComputerEngine::MCTS : ComputerEngine::SEARCH);
 
     recordButton->setText("Start Recording");
     recordButton->setEnabled(true);
@@ -418,8 +398,8 @@ void MainWindow::handleComputerTurn(){
             }
         }
 
-        // Start timer for computer move (1 second delay)
-        computerMoveTimer->start(1000);
+        // Start timer for computer move; the search fills the rest of the second
+        computerMoveTimer->start(1000 - COMPUTER_SEARCH_MS);
     } else {
         // Human turn, enable board
         updateBoard();
@@ -429,21 +409,43 @@ void MainWindow::handleComputerTurn(){
 void MainWindow::makeComputerMove(){
     computerMoveTimer->stop();
 
-    if (game->getState() != GameState::ONGOING){
+    if (game->getState() != GameState::ONGOING || computerMoveWatcher->isRunning()){
         return;
     }
 
+    int turn = computerTurn;
+    computerMoveWatcher->setFuture(QtConcurrent::run([this, turn]() {
+        ComputerChoice choice;
+        choice.found = game->chooseComputerMove(choice.move);
+        choice.turn = turn;
+        return choice;
+    }));
+}
+
+void MainWindow::computerMoveFinished(){
+    ComputerChoice choice = computerMoveWatcher->result();
+    if (choice.turn != computerTurn || !choice.found) {
+        return; // The game changed while the computer was thinking
+    }
+
     Player* movingPlayer = game->getCurrentPlayer();
-    int row, col;
 
-    if (game->makeComputerMove(row, col)){
-        checkAndDrawSOS(row, col, movingPlayer);
+    if (game->playComputerMove(choice.move)){
+        checkAndDrawSOS(choice.move.row, choice.move.col, movingPlayer);
         updateBoard();
 
         handleComputerTurn();
     }
 }
 
+// Drops any computer move in progress before the game is replaced. A search
+// cannot be interrupted, so this waits out the rest of it.
+void MainWindow::cancelComputerTurn(){
+    computerMoveTimer->stop();
+    computerMoveWatcher->waitForFinished();
+    computerTurn++;
+}
+
 void MainWindow::toggleRecording() {
     if (inReplayMode) {
         QMessageBox::warning(this, "Replay Mode", "Cannot record during replay!");
@@ -582,6 +584,7 @@ void MainWindow::loadRecording() {
     }
 
     // Start replay
+    cancelComputerTurn();
     inReplayMode = true;
     replayIndex = 0;
 
@@ -16,6 +16,7 @@
 #include <QMessageBox>
 #include <QDateTime>
 #include <QTextStream>
+#include <QFutureWatcher>
 #include <vector>
 #include <tuple>
 #include "game.h"
@@ -75,6 +76,16 @@ private:
     QTimer* computerMoveTimer;
     QTimer* replayTimer;
 
+    // The computer's move is chosen on a worker thread so the window keeps
+    // painting; the game is left alone until the result comes back
+    struct ComputerChoice {
+        bool found;
+        EngineMove move;
+        int turn;  // computerTurn when the search started
+    };
+    QFutureWatcher<ComputerChoice>* computerMoveWatcher;
+    int computerTurn;
+
     bool inReplayMode;
     std::vector<Game::MoveRecord> replayMoves;
     int replayIndex;
@@ -83,8 +94,8 @@ private:
     void createBoard();
     void updateBoard();
     void checkAndDrawSOS(int row, int col, Player* scorer);
-    bool checkSOSLine(int r1, int c1, int r2, int c2, int r3, int c3);
     void handleComputerTurn();
+    void cancelComputerTurn();
     void saveRecordingToFile();
     void loadRecordingFromFile();
     void playNextReplayMove();
@@ -93,6 +104,7 @@ private slots:
     void cellClicked();
     void startNewGame();
     void makeComputerMove();
+    void computerMoveFinished();
     void toggleRecording();
     void loadRecording();
 
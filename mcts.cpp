@@ -0,0 +1,406 @@
+#include "mcts.h"
+#include "zobrist.h"
+#include "soskernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+// UCT exploration constant for rewards in [0, 1]
+const float EXPLORATION = 1.0f;
+
+// Playouts through a leaf before it is expanded, so one-off visits don't
+// allocate a child per empty cell
+const uint32_t EXPAND_VISITS = 2;
+
+// Playouts a worker claims at once; the clock is read once per batch
+const long long BATCH = 16;
+
+// Nodes per pool chunk, unless a single expansion needs more
+const int MIN_CHUNK_SHIFT = 16;
+
+// Every iteration writes one of the root's children, so they are laid out
+// this many nodes (100 bytes) apart: no two share a cache line, and none
+// shares one with the root
+const uint32_t ROOT_SPACING = 5;
+
+const uint8_t S = static_cast<uint8_t>(CellState::S);
+const uint8_t O = static_cast<uint8_t>(CellState::O);
+}
+
+MctsEngine::MctsEngine()
+    : mode(GameMode::SIMPLE), rootLead(0), boardSize(0), rootSpacing(1),
+      chunkCount(0), chunkShift(0), poolCapacity(0), poolUsed(0),
+      playoutsClaimed(0), maxPlayouts(0), timeMs(0),
+      // Seeded from rand() so srand makes single-worker searches reproducible
+      seed(zobrist::mix(static_cast<uint64_t>(rand())) | 1) {}
+
+MctsEngine::~MctsEngine() {
+    releaseChunks();
+}
+
+MctsEngine::Node& MctsEngine::nodeAt(uint32_t index) const {
+    // Relaxed is enough: the index came from an acquire of some firstChild,
+    // published after its chunk was in place
+    Node* chunk = chunks[index >> chunkShift].load(std::memory_order_relaxed);
+    return chunk[index & ((1u << chunkShift) - 1)];
+}
+
+MctsEngine::Node* MctsEngine::chunkFor(size_t index) {
+    std::atomic<Node*>& slot = chunks[index >> chunkShift];
+    Node* chunk = slot.load(std::memory_order_acquire);
+    if (chunk == nullptr) {
+        // Workers reserving in a new chunk race to allocate it; one wins
+        Node* fresh = new Node[size_t(1) << chunkShift];
+        if (slot.compare_exchange_strong(chunk, fresh, std::memory_order_acq_rel)) {
+            chunk = fresh;
+        } else {
+            delete[] fresh;
+        }
+    }
+    return chunk;
+}
+
+void MctsEngine::releaseChunks() {
+    for (size_t i = 0; i < chunkCount; i++) {
+        delete[] chunks[i].load();
+    }
+    chunks.reset();
+    chunkCount = 0;
+}
+
+uint64_t MctsEngine::nextRandom(uint64_t& rng) {
+    // xorshift64*
+    rng ^= rng >> 12;
+    rng ^= rng << 25;
+    rng ^= rng >> 27;
+    return rng * 0x2545F4914F6CDD1DULL;
+}
+
+bool MctsEngine::search(const Board& position, GameMode gameMode, int scoreLead,
+                        const MctsLimits& limits, MctsResult& result) {
+    if (position.isFull()) {
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    timeMs = limits.timeMs;
+    deadline = start + std::chrono::milliseconds(timeMs);
+    maxPlayouts = limits.maxPlayouts;
+    if (maxPlayouts <= 0 && timeMs <= 0) {
+        maxPlayouts = DEFAULT_PLAYOUTS;
+    }
+    playoutsClaimed.store(0);
+
+    // The pool's chunks are kept between searches of the same shape. It
+    // always has room for the root's children, so there is a move to
+    // return, and a chunk holds the largest expansion this board can ask for.
+    size_t rootChildren = static_cast<size_t>(position.emptyCount()) * 2;
+    size_t capacity = limits.maxNodes > 0 ? limits.maxNodes : DEFAULT_MAX_NODES;
+    capacity = std::max(capacity, 1 + rootChildren);
+    int shift = MIN_CHUNK_SHIFT;
+    while ((size_t(1) << shift) < 1 + rootChildren) {
+        shift++;
+    }
+    size_t count = ((capacity - 1) >> shift) + 1;
+    if (shift != chunkShift || count != chunkCount) {
+        releaseChunks();
+        chunks.reset(new std::atomic<Node*>[count]);
+        for (size_t i = 0; i < count; i++) {
+            chunks[i].store(nullptr);
+        }
+        chunkCount = count;
+        chunkShift = shift;
+    }
+    poolCapacity = capacity;
+    // Spacing the root's children out needs room in the pool and the chunk
+    size_t spread = 1 + rootChildren * ROOT_SPACING;
+    rootSpacing = spread <= capacity && spread <= (size_t(1) << shift) ? ROOT_SPACING : 1;
+    Node& root = chunkFor(0)[0];
+    root.move = 0;
+    root.firstChild.store(0);
+    root.childCount.store(0);
+    root.visits.store(0);
+    root.halfWins.store(0);
+    poolUsed.store(1);
+
+    mode = gameMode;
+    rootLead = scoreLead;
+    boardSize = position.getSize();
+
+    int threads = std::max(limits.threads, 1);
+    workers.resize(threads);
+    uint64_t searchSeed = nextRandom(seed);
+    for (int i = 0; i < threads; i++) {
+        Worker& worker = workers[i];
+        // Descents only make, score and unmake moves: no tables needed
+        worker.board = position;
+        worker.board.setTracking(Board::TRACK_NONE);
+        worker.rng = zobrist::mix(searchSeed + i) | 1;
+    }
+    expand(workers[0], 0);
+
+    // The caller runs the first worker, the pool the rest
+    if (threads > 1) {
+        if (!threadPool || threadPool->threadCount() != threads - 1) {
+            threadPool.reset(new ThreadPool(threads - 1));
+        }
+        for (int i = 1; i < threads; i++) {
+            Worker& worker = workers[i];
+            threadPool->submit([this, &worker] { run(worker); });
+        }
+    }
+    run(workers[0]);
+    if (threads > 1) {
+        threadPool->wait();
+    }
+
+    // The most visited move is the most trusted
+    Node* children = &nodeAt(root.firstChild.load()) + (rootSpacing - 1);
+    Node* best = children;
+    for (uint32_t i = 0; i < root.childCount.load(); i++) {
+        Node& child = children[i * rootSpacing];
+        if (child.visits.load() > best->visits.load()) {
+            best = &child;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint32_t bestVisits = best->visits.load();
+    result.move = decodeMove(best->move);
+    result.playouts = root.visits.load();
+    result.playoutsPerSecond = seconds > 0 ? result.playouts / seconds : 0;
+    result.winRate = bestVisits > 0 ? best->halfWins.load() / (2.0 * bestVisits) : 0.5;
+    result.nodes = poolUsed.load();
+    return true;
+}
+
+void MctsEngine::run(Worker& worker) {
+    Node& root = nodeAt(0);
+    while (true) {
+        if (timeMs > 0 && std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+        // The shared counter is only touched when playouts are limited; a
+        // batch past the limit is cut to what is left, so the total is exact
+        long long batch = BATCH;
+        if (maxPlayouts > 0) {
+            long long first = playoutsClaimed.fetch_add(BATCH, std::memory_order_relaxed);
+            if (first >= maxPlayouts) {
+                break;
+            }
+            batch = std::min(BATCH, maxPlayouts - first);
+        }
+        // The root's visits for the whole batch, counted up front
+        root.visits.fetch_add(static_cast<uint32_t>(batch), std::memory_order_relaxed);
+        for (long long i = 0; i < batch; i++) {
+            iterate(worker);
+        }
+    }
+}
+
+void MctsEngine::iterate(Worker& worker) {
+    Board& board = worker.board;
+
+    // Selection and expansion, making the moves on the worker's board.
+    // Visits are counted on the way down: a virtual loss until backup.
+    // The root's own visit was counted when the playout was claimed, and
+    // its wins are never read, so it stays off the path.
+    worker.path.clear();
+    worker.pathMoves.clear();
+    uint32_t node = 0;
+    int mover = 0;
+    int lead = rootLead;
+    bool over = false;
+    uint32_t reward = 1;
+
+    while (true) {
+        uint32_t first = nodeAt(node).firstChild.load(std::memory_order_acquire);
+        if (first == 0 || first == EXPANDING) {
+            // This visit is already counted, hence '>'
+            if (first == 0 && nodeAt(node).visits.load(std::memory_order_relaxed) > EXPAND_VISITS &&
+                !board.isFull() && expand(worker, node)) {
+                continue;
+            }
+            break;
+        }
+
+        uint32_t child = selectChild(node);
+        nodeAt(child).visits.fetch_add(1, std::memory_order_relaxed);
+        EngineMove move = decodeMove(nodeAt(child).move);
+        int points = board.checkForSOS(move.row, move.col, move.letter);
+        board.makeMove(move.row, move.col, move.letter);
+        worker.pathMoves.push_back(move);
+        worker.path.push_back({child, mover});
+        node = child;
+
+        if (points > 0) {
+            if (mode == GameMode::SIMPLE) {
+                over = true;
+                reward = mover == 0 ? 2 : 0;
+                break;
+            }
+            lead += mover == 0 ? points : -points;
+        } else {
+            mover ^= 1;
+        }
+        if (board.isFull()) {
+            over = true;
+            reward = mode == GameMode::SIMPLE ? 1 : leadReward(lead);
+            break;
+        }
+    }
+
+    if (!over) {
+        reward = playout(worker, mover, lead);
+    }
+
+    // Backpropagation: each node is credited for the player who moved into it
+    for (const PathStep& step : worker.path) {
+        nodeAt(step.node).halfWins.fetch_add(step.mover == 0 ? reward : 2 - reward,
+                                           std::memory_order_relaxed);
+    }
+    for (size_t i = worker.pathMoves.size(); i > 0; i--) {
+        board.unmakeMove(worker.pathMoves[i - 1].row, worker.pathMoves[i - 1].col);
+    }
+}
+
+bool MctsEngine::expand(Worker& worker, uint32_t node) {
+    const Board& board = worker.board;
+    size_t count = static_cast<size_t>(board.emptyCount()) * 2;
+    // Child i sits at spacing * i + spacing - 1 in the range
+    uint32_t spacing = node == 0 ? rootSpacing : 1;
+    size_t span = count * spacing;
+    if (poolUsed.load(std::memory_order_relaxed) + span > poolCapacity) {
+        return false;
+    }
+
+    // Claim the node; losing the race means another worker is building it
+    Node& parent = nodeAt(node);
+    uint32_t expected = 0;
+    if (!parent.firstChild.compare_exchange_strong(expected, EXPANDING,
+                                                   std::memory_order_acquire)) {
+        return false;
+    }
+
+    // Reserve the range, starting a new chunk rather than crossing into one.
+    // Nothing is taken unless it fits, so the used count stays exact.
+    size_t chunkSize = size_t(1) << chunkShift;
+    size_t used = poolUsed.load(std::memory_order_relaxed);
+    size_t first;
+    do {
+        first = used;
+        if ((first & (chunkSize - 1)) + span > chunkSize) {
+            first = (first | (chunkSize - 1)) + 1;
+        }
+        if (first + span > poolCapacity) {
+            // Pool ran out under us: give the node back as a plain leaf
+            parent.firstChild.store(0, std::memory_order_relaxed);
+            return false;
+        }
+    } while (!poolUsed.compare_exchange_weak(used, first + span, std::memory_order_relaxed));
+
+    Node* children = chunkFor(first) + (first & (chunkSize - 1)) + (spacing - 1);
+    for (int i = 0; i < board.emptyCount(); i++) {
+        int row, col;
+        board.emptyCellAt(i, row, col);
+        uint32_t cell = static_cast<uint32_t>(row * boardSize + col);
+        for (uint32_t letter = 0; letter < 2; letter++) {
+            Node& child = children[(2 * i + letter) * spacing];
+            child.move = cell * 2 + letter;
+            child.firstChild.store(0, std::memory_order_relaxed);
+            child.childCount.store(0, std::memory_order_relaxed);
+            child.visits.store(0, std::memory_order_relaxed);
+            child.halfWins.store(0, std::memory_order_relaxed);
+        }
+    }
+    // Publishing firstChild releases the children to other workers
+    parent.childCount.store(static_cast<uint32_t>(count), std::memory_order_relaxed);
+    parent.firstChild.store(static_cast<uint32_t>(first), std::memory_order_release);
+    return true;
+}
+
+uint32_t MctsEngine::selectChild(uint32_t node) const {
+    const Node& parent = nodeAt(node);
+    uint32_t first = parent.firstChild.load(std::memory_order_acquire);
+    uint32_t count = parent.childCount.load(std::memory_order_relaxed);
+    float logVisits = std::log(static_cast<float>(parent.visits.load(std::memory_order_relaxed)) + 1.0f);
+
+    // A node's children never cross a chunk
+    uint32_t spacing = node == 0 ? rootSpacing : 1;
+    first += spacing - 1;
+    const Node* children = &nodeAt(first);
+    uint32_t best = 0;
+    float bestValue = -1.0f;
+    for (uint32_t i = 0; i < count; i++) {
+        const Node& child = children[i * spacing];
+        uint32_t visits = child.visits.load(std::memory_order_relaxed);
+        if (visits == 0) {
+            return first + i * spacing;
+        }
+        float wins = child.halfWins.load(std::memory_order_relaxed) * 0.5f;
+        float value = wins / visits + EXPLORATION * std::sqrt(logVisits / visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = i;
+        }
+    }
+    return first + best * spacing;
+}
+
+uint32_t MctsEngine::playout(Worker& worker, int mover, int lead) const {
+    const Board& board = worker.board;
+    const uint8_t* cells = board.data();
+    int stride = board.getStride();
+    worker.scratch.assign(cells, cells + stride * stride);
+    worker.scratchEmpty.clear();
+    for (int i = 0; i < board.emptyCount(); i++) {
+        int row, col;
+        board.emptyCellAt(i, row, col);
+        worker.scratchEmpty.push_back(board.index(row, col));
+    }
+    const int steps[4] = {1, stride, stride + 1, 1 - stride};
+    uint8_t* scratch = worker.scratch.data();
+    std::vector<int>& empty = worker.scratchEmpty;
+
+    while (!empty.empty()) {
+        uint32_t n = static_cast<uint32_t>(empty.size());
+        uint32_t pick = static_cast<uint32_t>(((nextRandom(worker.rng) >> 32) * n) >> 32);
+        int index = empty[pick];
+        empty[pick] = empty.back();
+        empty.pop_back();
+
+        // Take an SOS the cell offers, else play either letter
+        int sGain = soskernels::sosAt(scratch, index, CellState::S, steps);
+        int oGain = soskernels::sosAt(scratch, index, CellState::O, steps);
+        uint8_t letter;
+        int points;
+        if (sGain > 0 || oGain > 0) {
+            letter = sGain >= oGain ? S : O;
+            points = sGain >= oGain ? sGain : oGain;
+        } else {
+            letter = (nextRandom(worker.rng) >> 63) ? S : O;
+            points = 0;
+        }
+        scratch[index] = letter;
+
+        if (points > 0) {
+            if (mode == GameMode::SIMPLE) {
+                return mover == 0 ? 2 : 0;
+            }
+            lead += mover == 0 ? points : -points;
+        } else {
+            mover ^= 1;
+        }
+    }
+    return mode == GameMode::SIMPLE ? 1 : leadReward(lead);
+}
+
+uint32_t MctsEngine::leadReward(int lead) const {
+    return lead > 0 ? 2 : (lead < 0 ? 0 : 1);
+}
+
+EngineMove MctsEngine::decodeMove(uint32_t code) const {
+    int cell = static_cast<int>(code / 2);
+    return {cell / boardSize, cell % boardSize, (code & 1) ? 'O' : 'S'};
+}
@@ -0,0 +1,138 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "enums.h"
+#include "board.h"
+#include "engine.h"
+#include "threadpool.h"
+
+// Limits for one MCTS search; a zero limit is not applied. With neither
+// time nor playouts set the search stops at DEFAULT_PLAYOUTS.
+struct MctsLimits {
+    int timeMs;
+    long long maxPlayouts;
+    size_t maxNodes;     // tree size cap; leaves stop expanding when reached
+    int threads;         // workers sharing the tree, the caller included; 0 means 1
+};
+
+struct MctsResult {
+    EngineMove move;
+    long long playouts;
+    double playoutsPerSecond;
+    double winRate;      // of the chosen move, for the side to move
+    size_t nodes;
+};
+
+// Monte Carlo tree search with UCT selection, tree-parallel over any
+// number of workers. The tree is a pool of 20-byte nodes holding a move
+// and its statistics, children contiguous; positions are never stored.
+// The pool is allocated in chunks as the tree grows and kept for the next
+// search, so a short search does not pay for the whole node cap.
+//
+// Each iteration walks down from the root with make/unmake on the
+// worker's own Board, then plays out on a copy of the raw cell buffer
+// with a light policy (take the larger SOS if the random cell has one,
+// otherwise a random letter). General-mode scoring keeps the turn; a
+// playout's reward is the game result (win 1, draw 0.5, loss 0).
+//
+// Workers share the tree without locks. Statistics are atomic counters,
+// and a visit is counted on the way down (a virtual loss until the reward
+// arrives), which steers other workers to different branches. A leaf is
+// expanded by whichever worker claims it with a compare-and-swap, into a
+// range of the pool reserved with a compare-and-swap on the used count;
+// the others play out from the leaf meanwhile. Playouts are claimed, and
+// counted at the root, a batch at a time, so the shared counters are not
+// written on every iteration. The caller runs one worker itself.
+//
+// Every iteration writes one of the root's children, so while the pool
+// has room they are spaced a cache line apart rather than packed. Deeper
+// siblings stay contiguous: below the root the writes spread over far
+// more nodes, and spacing them all would multiply the pool.
+class MctsEngine {
+public:
+    static constexpr long long DEFAULT_PLAYOUTS = 10000;
+    static constexpr size_t DEFAULT_MAX_NODES = 4000000;
+
+    MctsEngine();
+    ~MctsEngine();
+    MctsEngine(const MctsEngine&) = delete;
+    MctsEngine& operator=(const MctsEngine&) = delete;
+
+    // 'scoreLead' is the side to move's score minus the opponent's, so
+    // general-mode playouts are judged on the whole game. Returns false
+    // when the board is full.
+    bool search(const Board& position, GameMode gameMode, int scoreLead, const MctsLimits& limits,
+                MctsResult& result);
+
+private:
+    struct Node {
+        uint32_t move;                    // (row * size + col) * 2 + (letter == 'O')
+        std::atomic<uint32_t> firstChild; // 0 until expanded, EXPANDING while being built
+        std::atomic<uint32_t> childCount;
+        std::atomic<uint32_t> visits;     // including playouts still in flight
+        std::atomic<uint32_t> halfWins;   // rewards in halves, for the player who made 'move'
+    };
+    static_assert(sizeof(Node) == 20, "nodes stay compact");
+    static constexpr uint32_t EXPANDING = 0xFFFFFFFF;
+
+    // One step of the walk down the tree
+    struct PathStep {
+        uint32_t node;
+        int mover;           // 0 for the root's side to move, 1 for the other
+    };
+
+    // Everything a worker changes while it runs
+    struct Worker {
+        Board board;                      // root position, restored after every iteration
+        std::vector<PathStep> path;
+        std::vector<EngineMove> pathMoves;
+        std::vector<uint8_t> scratch;     // playout copy of the cell buffer
+        std::vector<int> scratchEmpty;    // buffer indices of its empty cells
+        uint64_t rng;
+    };
+
+    // Shared by the workers of one search
+    GameMode mode;
+    int rootLead;
+    int boardSize;
+    uint32_t rootSpacing;     // nodes from one root child to the next; 1 when packed
+    // Node i lives in chunks[i >> chunkShift]; a chunk is allocated by the
+    // first worker to reserve a range in it, and no range crosses chunks
+    std::unique_ptr<std::atomic<Node*>[]> chunks;
+    size_t chunkCount;
+    int chunkShift;
+    size_t poolCapacity;
+    std::atomic<size_t> poolUsed;
+    std::atomic<long long> playoutsClaimed;
+    long long maxPlayouts;
+    int timeMs;
+    std::chrono::steady_clock::time_point deadline;
+
+    std::vector<Worker> workers;
+    std::unique_ptr<ThreadPool> threadPool;
+    // Advanced once per search to seed the workers, so a search never calls
+    // rand() and may run on any thread
+    uint64_t seed;
+
+    Node& nodeAt(uint32_t index) const;
+    Node* chunkFor(size_t index);
+    void releaseChunks();
+    void run(Worker& worker);
+    void iterate(Worker& worker);
+    bool expand(Worker& worker, uint32_t node);
+    uint32_t selectChild(uint32_t node) const;
+    // Plays the position out from 'mover' to move with 'lead' points ahead
+    // for the root side; returns the reward for the root side in halves
+    uint32_t playout(Worker& worker, int mover, int lead) const;
+    uint32_t leadReward(int lead) const;
+    EngineMove decodeMove(uint32_t code) const;
+    static uint64_t nextRandom(uint64_t& rng);
+};
+
+#endif // MCTS_H
@@ -0,0 +1,124 @@
+#include "packedboard.h"
+#include "bitboard.h"
+#include <algorithm>
+
+namespace {
+// Low bit of every 2-bit cell
+const uint64_t LOW_BITS = 0x5555555555555555ULL;
+
+// Mask of the low bits that belong to real cells in word w
+uint64_t usedLanes(long long cellCount, size_t w) {
+    long long remaining = cellCount - static_cast<long long>(w) * 32;
+    if (remaining >= 32) {
+        return LOW_BITS;
+    }
+    return LOW_BITS & ((uint64_t(1) << (remaining * 2)) - 1);
+}
+}
+
+PackedBoard::PackedBoard(int boardSize) : size(boardSize) {
+    if (boardSize < 3) {
+        size = 3; // Minimum valid size
+    }
+    long long cellCount = static_cast<long long>(size) * size;
+    words.assign((cellCount + 31) / 32, 0);
+}
+
+int PackedBoard::getSize() const {
+    return size;
+}
+
+CellState PackedBoard::getCell(int row, int col) const {
+    if (row >= 0 && row < size && col >= 0 && col < size) {
+        return cellAt(static_cast<long long>(row) * size + col);
+    }
+    return CellState::EMPTY;
+}
+
+bool PackedBoard::isEmpty(int row, int col) const {
+    return getCell(row, col) == CellState::EMPTY;
+}
+
+bool PackedBoard::isFull() const {
+    // A cell is occupied when either of its two bits is set, so folding the
+    // high bit onto the low bit must leave every used lane set
+    long long cellCount = static_cast<long long>(size) * size;
+    for (size_t w = 0; w < words.size(); w++) {
+        uint64_t lanes = usedLanes(cellCount, w);
+        if (((words[w] | (words[w] >> 1)) & lanes) != lanes) {
+            return false;
+        }
+    }
+    return true;
+}
+
+long long PackedBoard::emptyCount() const {
+    long long cellCount = static_cast<long long>(size) * size;
+    long long occupied = 0;
+    for (size_t w = 0; w < words.size(); w++) {
+        uint64_t filled = (words[w] | (words[w] >> 1)) & usedLanes(cellCount, w);
+        occupied += popcount64(filled);
+    }
+    return cellCount - occupied;
+}
+
+size_t PackedBoard::memoryBytes() const {
+    return words.size() * sizeof(uint64_t);
+}
+
+bool PackedBoard::makeMove(int row, int col, char letter) {
+    if (row < 0 || row >= size || col < 0 || col >= size) {
+        return false;
+    }
+
+    long long cell = static_cast<long long>(row) * size + col;
+    if (cellAt(cell) != CellState::EMPTY) {
+        return false;
+    }
+
+    uint64_t code;
+    if (letter == 'S') {
+        code = static_cast<uint64_t>(CellState::S);
+    } else if (letter == 'O') {
+        code = static_cast<uint64_t>(CellState::O);
+    } else {
+        return false;
+    }
+
+    words[cell >> 5] |= code << ((cell & 31) * 2);
+    return true;
+}
+
+int PackedBoard::checkForSOS(int row, int col) const {
+    int count = 0;
+    CellState placed = getCell(row, col);
+
+    // Same rules as Board::checkForSOS: a placed S is checked as either end
+    // of the triple, a placed O as its middle
+    int lines[4][2] = {{0, 1}, {1, 0}, {1, 1}, {-1, 1}};
+
+    for (int i = 0; i < 4; i++) {
+        int dr = lines[i][0];
+        int dc = lines[i][1];
+
+        if (placed == CellState::S) {
+            for (int sign = -1; sign <= 1; sign += 2) {
+                if (getCell(row + sign * dr, col + sign * dc) == CellState::O &&
+                    getCell(row + 2 * sign * dr, col + 2 * sign * dc) == CellState::S) {
+                    count++;
+                }
+            }
+        } else if (placed == CellState::O) {
+            if (getCell(row - dr, col - dc) == CellState::S &&
+                getCell(row + dr, col + dc) == CellState::S) {
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+void PackedBoard::reset() {
+    std::fill(words.begin(), words.end(), 0);
+}
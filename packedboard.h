@@ -0,0 +1,37 @@
+#ifndef PACKEDBOARD_H
+#define PACKEDBOARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "enums.h"
+
+// Memory-lean board for very large sizes: 2 bits per cell, 32 cells per
+// 64-bit word, row-major with no padding. Codes match CellState
+// (00 empty, 01 S, 10 O). Same interface as Board for the basic game
+// operations, without the line views and empty-cell set.
+class PackedBoard {
+private:
+    int size;
+    std::vector<uint64_t> words;
+
+    CellState cellAt(long long cell) const {
+        return static_cast<CellState>((words[cell >> 5] >> ((cell & 31) * 2)) & 3);
+    }
+
+public:
+    PackedBoard(int boardSize = 8);
+
+    int getSize() const;
+    CellState getCell(int row, int col) const;
+    bool isEmpty(int row, int col) const;
+    bool isFull() const;
+    long long emptyCount() const;
+    size_t memoryBytes() const;
+
+    bool makeMove(int row, int col, char letter);
+    int checkForSOS(int row, int col) const;
+    void reset();
+};
+
+#endif // PACKEDBOARD_H
@@ -36,6 +36,10 @@ void Player::addScore(int points) {
     score += points;
 }
 
+void Player::subtractScore(int points) {
+    score -= points;
+}
+
 void Player::resetScore() {
     score = 0;
 }
@@ -21,6 +21,7 @@ public:
 
     void setCurrentLetter(char letter);
     void addScore(int points);
+    void subtractScore(int points);
     void resetScore();
 
     //computer functionality
@@ -0,0 +1,266 @@
+#include "search.h"
+#include "zobrist.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+const int INFINITE_SCORE = 2 * SearchEngine::WIN_SCORE;
+
+// Limits are checked every NODE_CHECK nodes
+const long long NODE_CHECK = 1024;
+
+// Longest run of scoring moves a leaf cashes in
+const int MAX_CASH_IN = 64;
+
+bool sameMove(const EngineMove& a, const EngineMove& b) {
+    return a.row == b.row && a.col == b.col && a.letter == b.letter;
+}
+
+// Simple-mode wins are stored relative to the node, not the root, so the
+// same position found at another ply reads back the right distance
+bool isWinScore(int score) {
+    return std::abs(score) >= SearchEngine::WIN_SCORE - SearchEngine::MAX_PLY;
+}
+
+int scoreToTable(int score, int ply) {
+    return isWinScore(score) ? score + (score > 0 ? ply : -ply) : score;
+}
+
+int scoreFromTable(int score, int ply) {
+    return isWinScore(score) ? score - (score > 0 ? ply : -ply) : score;
+}
+}
+
+SearchEngine::SearchEngine()
+    : mode(GameMode::SIMPLE), limits{0, 0, 0}, nodes(0), nextCheck(0), stopped(false),
+      rootBest{-1, -1, 'S'}, tableHits(0),
+      // Seeded from rand() so srand keeps searches reproducible
+      rng(static_cast<unsigned>(rand())), tableMB(DEFAULT_TABLE_MB), moveLists(MAX_PLY + 1) {}
+
+void SearchEngine::setTableSize(int megabytes) {
+    tableMB = megabytes;
+    if (!table.empty()) {
+        table.resize(tableMB);
+    }
+}
+
+void SearchEngine::clearTable() {
+    if (!table.empty()) {
+        table.clear();
+    }
+}
+
+bool SearchEngine::search(const Board& position, GameMode gameMode, const SearchLimits& searchLimits,
+                          SearchResult& result) {
+    if (position.isFull()) {
+        return false;
+    }
+
+    // Move ordering and leaf evaluation read the threat map and setups
+    board = position;
+    board.setTracking(Board::TRACK_ENGINE);
+    mode = gameMode;
+    limits = searchLimits;
+    deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(limits.timeMs);
+    nodes = 0;
+    nextCheck = NODE_CHECK;
+    stopped = false;
+    tableHits = 0;
+    if (table.empty()) {
+        table.resize(tableMB);
+    }
+    table.newSearch();
+
+    // The greedy choice stands in until the first iteration completes
+    chooseGreedyMove(board, rng, rootBest);
+    result.move = rootBest;
+    result.score = 0;
+    result.depth = 0;
+
+    // Deeper than the empty cells there is nothing left to search
+    int maxDepth = std::min(board.emptyCount(), MAX_PLY);
+    if (limits.maxDepth > 0) {
+        maxDepth = std::min(maxDepth, limits.maxDepth);
+    }
+
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        int score = negamax(depth, -INFINITE_SCORE, INFINITE_SCORE, 0);
+        if (stopped) {
+            break;
+        }
+        result.move = rootBest;
+        result.score = score;
+        result.depth = depth;
+
+        // A decided simple game needs no deeper look
+        if (isWinScore(score)) {
+            break;
+        }
+    }
+    result.nodes = nodes;
+    result.tableHits = tableHits;
+    return true;
+}
+
+int SearchEngine::negamax(int depth, int alpha, int beta, int ply) {
+    if (board.isFull()) {
+        return 0;
+    }
+    if (depth == 0 || ply >= MAX_PLY) {
+        return evaluate(ply);
+    }
+
+    if (++nodes >= nextCheck) {
+        nextCheck = nodes + NODE_CHECK;
+        checkLimits();
+    }
+    if (stopped) {
+        return 0;
+    }
+
+    uint64_t key = board.hash() ^ (mode == GameMode::GENERAL ? zobrist::GENERAL_KEY : 0);
+    TranspositionTable::Entry entry;
+    EngineMove tableMove;
+    bool haveTableMove = false;
+    if (table.probe(key, entry)) {
+        tableHits++;
+        if (entry.move != TranspositionTable::NO_MOVE) {
+            tableMove = decodeMove(entry.move);
+            haveTableMove = true;
+        }
+        // The root always searches, so it has a move to return
+        if (ply > 0 && entry.depth >= depth) {
+            int score = scoreFromTable(entry.score, ply);
+            if (entry.bound == TranspositionTable::EXACT ||
+                (entry.bound == TranspositionTable::LOWER && score >= beta) ||
+                (entry.bound == TranspositionTable::UPPER && score <= alpha)) {
+                return score;
+            }
+        }
+    }
+
+    std::vector<ScoredMove>& moves = moveLists[ply];
+    generateMoves(moves, ply == 0 ? &rootBest : (haveTableMove ? &tableMove : nullptr));
+
+    int alphaStart = alpha;
+    int best = -INFINITE_SCORE;
+    EngineMove bestMove = moves[0].move;
+    for (size_t i = 0; i < moves.size(); i++) {
+        const EngineMove& move = moves[i].move;
+        int points = board.checkForSOS(move.row, move.col, move.letter);
+
+        int value;
+        if (points > 0 && mode == GameMode::SIMPLE) {
+            value = WIN_SCORE - ply;
+        } else {
+            board.makeMove(move.row, move.col, move.letter);
+            if (points > 0) {
+                // Same side moves again: no negation, window shifted by the points
+                value = points + negamax(depth - 1, alpha - points, beta - points, ply + 1);
+            } else {
+                value = -negamax(depth - 1, -beta, -alpha, ply + 1);
+            }
+            board.unmakeMove(move.row, move.col);
+        }
+        if (stopped) {
+            return 0;
+        }
+
+        if (value > best) {
+            best = value;
+            bestMove = move;
+            if (ply == 0) {
+                rootBest = move;
+            }
+        }
+        if (best > alpha) {
+            alpha = best;
+        }
+        if (alpha >= beta) {
+            break;
+        }
+    }
+
+    TranspositionTable::Bound bound = best <= alphaStart ? TranspositionTable::UPPER
+                                      : best >= beta     ? TranspositionTable::LOWER
+                                                         : TranspositionTable::EXACT;
+    table.store(key, depth, scoreToTable(best, ply), bound, encodeMove(bestMove));
+    return best;
+}
+
+int SearchEngine::evaluate(int ply) {
+    nodes++;
+    if (mode == GameMode::SIMPLE) {
+        return board.scoringMoveCount() > 0 ? WIN_SCORE - ply : 0;
+    }
+
+    EngineMove taken[MAX_CASH_IN];
+    int count = 0;
+    int total = 0;
+    while (board.scoringMoveCount() > 0 && count < MAX_CASH_IN) {
+        EngineMove best{-1, -1, 'S'};
+        int bestGain = 0;
+        for (int i = 0; i < board.scoringMoveCount(); i++) {
+            int row, col;
+            board.scoringCellAt(i, row, col);
+            if (board.sGain(row, col) > bestGain) {
+                bestGain = board.sGain(row, col);
+                best = {row, col, 'S'};
+            }
+            if (board.oGain(row, col) > bestGain) {
+                bestGain = board.oGain(row, col);
+                best = {row, col, 'O'};
+            }
+        }
+        board.makeMove(best.row, best.col, best.letter);
+        taken[count++] = best;
+        total += bestGain;
+    }
+    while (count > 0) {
+        count--;
+        board.unmakeMove(taken[count].row, taken[count].col);
+    }
+    return total;
+}
+
+void SearchEngine::generateMoves(std::vector<ScoredMove>& moves, const EngineMove* first) {
+    moves.clear();
+    for (int i = 0; i < board.emptyCount(); i++) {
+        int row, col;
+        board.emptyCellAt(i, row, col);
+        const char letters[2] = {'S', 'O'};
+        for (char letter : letters) {
+            int gain = letter == 'S' ? board.sGain(row, col) : board.oGain(row, col);
+            int setups = letter == 'S' ? board.sSetups(row, col) : board.oSetups(row, col);
+
+            // Scoring moves by size, then quiet moves by how little they
+            // give the opponent
+            int order = gain > 0 ? 1024 + gain * 32 - setups : -setups;
+            if (first && sameMove(*first, {row, col, letter})) {
+                order = INFINITE_SCORE;
+            }
+            moves.push_back({{row, col, letter}, order});
+        }
+    }
+    std::stable_sort(moves.begin(), moves.end(),
+                     [](const ScoredMove& a, const ScoredMove& b) { return a.order > b.order; });
+}
+
+uint32_t SearchEngine::encodeMove(const EngineMove& move) const {
+    uint32_t cell = static_cast<uint32_t>(move.row * board.getSize() + move.col);
+    return cell * 2 + (move.letter == 'O');
+}
+
+EngineMove SearchEngine::decodeMove(uint32_t code) const {
+    int cell = static_cast<int>(code / 2);
+    return {cell / board.getSize(), cell % board.getSize(), (code & 1) ? 'O' : 'S'};
+}
+
+void SearchEngine::checkLimits() {
+    if (limits.maxNodes > 0 && nodes >= limits.maxNodes) {
+        stopped = true;
+    }
+    if (limits.timeMs > 0 && std::chrono::steady_clock::now() >= deadline) {
+        stopped = true;
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <chrono>
+#include <random>
+#include <vector>
+#include "enums.h"
+#include "board.h"
+#include "engine.h"
+#include "transtable.h"
+
+// Limits for one search; a zero limit is not applied
+struct SearchLimits {
+    int maxDepth;
+    int timeMs;          // wall-clock budget
+    long long maxNodes;
+};
+
+struct SearchResult {
+    EngineMove move;
+    int score;           // for the side to move: SOS still to gain over the
+                         // opponent, or near +/-WIN_SCORE for a simple-mode result
+    int depth;           // deepest fully searched iteration
+    long long nodes;
+    long long tableHits; // probes that found the position
+};
+
+// Negamax with alpha-beta over (cell, letter) moves and iterative
+// deepening. A scoring move keeps the turn in general mode, so its child
+// is searched for the same side without negation; in simple mode it ends
+// the game. When a limit runs out the best move of the last completed
+// iteration is returned, so a search always has an answer after depth 1.
+class SearchEngine {
+public:
+    static constexpr int WIN_SCORE = 1000000;
+    static constexpr int MAX_PLY = 128;
+    static constexpr int DEFAULT_TABLE_MB = 16;
+
+    SearchEngine();
+
+    // Transposition table size, allocated on the next search
+    void setTableSize(int megabytes);
+    int getTableSize() const { return tableMB; }
+    // Forgets every stored position, e.g. for a new game
+    void clearTable();
+
+    // Best move for the side to move on 'position'. Returns false when
+    // the board is full.
+    bool search(const Board& position, GameMode gameMode, const SearchLimits& limits,
+                SearchResult& result);
+
+private:
+    struct ScoredMove {
+        EngineMove move;
+        int order;
+    };
+
+    Board board;                 // working copy, searched with make/unmake
+    GameMode mode;
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point deadline;
+    long long nodes;
+    long long nextCheck;         // node count at which limits are next checked
+    bool stopped;
+    EngineMove rootBest;
+    long long tableHits;
+    // Breaks the greedy fallback's ties; owned here so a search on a worker
+    // thread never touches rand()
+    std::mt19937 rng;
+
+    // SOS is impartial: both players have the same moves and the negamax
+    // value counts only points still to come, so a position's value
+    // depends on the cells alone and the board hash is a complete key
+    TranspositionTable table;
+    int tableMB;
+    // Move lists per ply, kept between searches to avoid reallocating
+    std::vector<std::vector<ScoredMove>> moveLists;
+
+    int negamax(int depth, int alpha, int beta, int ply);
+    // Leaf value: in general mode the side to move first cashes in the
+    // best scoring move available, repeatedly; in simple mode any scoring
+    // move is a win
+    int evaluate(int ply);
+    void generateMoves(std::vector<ScoredMove>& moves, const EngineMove* first);
+    uint32_t encodeMove(const EngineMove& move) const;
+    EngineMove decodeMove(uint32_t code) const;
+    void checkLimits();
+};
+
+#endif // SEARCH_H
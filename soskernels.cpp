@@ -0,0 +1,327 @@
+#include "soskernels.h"
+#include "bitboard.h"
+
+#if defined(SOS_X86)
+#include <immintrin.h>
+#endif
+
+namespace soskernels {
+
+namespace {
+// Triples starting in word w; reads word w + 1 when there is one
+inline uint64_t tripleWord(const uint64_t* s, const uint64_t* o, int w, int words) {
+    uint64_t sNext = (w + 1 < words) ? s[w + 1] : 0;
+    uint64_t oNext = (w + 1 < words) ? o[w + 1] : 0;
+    uint64_t o1 = (o[w] >> 1) | (oNext << 63);
+    uint64_t s2 = (s[w] >> 2) | (sNext << 62);
+    return s[w] & o1 & s2;
+}
+}
+
+namespace {
+const uint8_t S = static_cast<uint8_t>(CellState::S);
+const uint8_t O = static_cast<uint8_t>(CellState::O);
+
+// Triples starting at cells [from, to) of one framed row
+inline int framedRun(const uint8_t* row, int from, int to, const int* steps) {
+    int count = 0;
+    for (int col = from; col < to; col++) {
+        const uint8_t* c = row + col;
+        for (int line = 0; line < 4; line++) {
+            int d = steps[line];
+            count += (c[0] == S) & (c[d] == O) & (c[2 * d] == S);
+        }
+    }
+    return count;
+}
+
+// First cell of each board row, and the line steps matching Board's
+inline const uint8_t* framedRow(const uint8_t* cells, int stride, int row) {
+    return cells + (row + 2) * stride + 2;
+}
+inline void framedSteps(int stride, int* steps) {
+    steps[0] = 1;
+    steps[1] = stride;
+    steps[2] = stride + 1;
+    steps[3] = 1 - stride;
+}
+}
+
+int countFramedTriplesScalar(const uint8_t* cells, int size, int stride) {
+    int steps[4];
+    framedSteps(stride, steps);
+    int count = 0;
+    for (int row = 0; row < size; row++) {
+        count += framedRun(framedRow(cells, stride, row), 0, size, steps);
+    }
+    return count;
+}
+
+int countTriplesScalar(const uint64_t* s, const uint64_t* o, int words) {
+    int count = 0;
+    for (int w = 0; w < words; w++) {
+        count += popcount64(tripleWord(s, o, w, words));
+    }
+    return count;
+}
+
+#if defined(SOS_X86)
+namespace {
+// Per 64-bit lane popcount: SWAR down to bytes, then sum bytes with psadbw
+SOS_TARGET("sse2") inline __m128i popcountLanes(__m128i x) {
+    const __m128i m1 = _mm_set1_epi8(0x55);
+    const __m128i m2 = _mm_set1_epi8(0x33);
+    const __m128i m4 = _mm_set1_epi8(0x0F);
+    x = _mm_sub_epi8(x, _mm_and_si128(_mm_srli_epi64(x, 1), m1));
+    x = _mm_add_epi8(_mm_and_si128(x, m2), _mm_and_si128(_mm_srli_epi64(x, 2), m2));
+    x = _mm_and_si128(_mm_add_epi8(x, _mm_srli_epi64(x, 4)), m4);
+    return _mm_sad_epu8(x, _mm_setzero_si128());
+}
+}
+
+SOS_TARGET("sse2")
+int countTriplesSSE2(const uint64_t* s, const uint64_t* o, int words) {
+    __m128i total = _mm_setzero_si128();
+    int w = 0;
+
+    // Two words per step; the loads at w + 1 need one word past the pair
+    for (; w + 2 < words; w += 2) {
+        __m128i sw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + w));
+        __m128i ow = _mm_loadu_si128(reinterpret_cast<const __m128i*>(o + w));
+        __m128i sn = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + w + 1));
+        __m128i on = _mm_loadu_si128(reinterpret_cast<const __m128i*>(o + w + 1));
+
+        __m128i o1 = _mm_or_si128(_mm_srli_epi64(ow, 1), _mm_slli_epi64(on, 63));
+        __m128i s2 = _mm_or_si128(_mm_srli_epi64(sw, 2), _mm_slli_epi64(sn, 62));
+        total = _mm_add_epi64(total, popcountLanes(_mm_and_si128(sw, _mm_and_si128(o1, s2))));
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), total);
+    int count = static_cast<int>(lanes[0] + lanes[1]);
+
+    for (; w < words; w++) {
+        count += popcount64(tripleWord(s, o, w, words));
+    }
+    return count;
+}
+
+namespace {
+// 0xFF in each lane whose byte at 'p' equals 'value'
+SOS_TARGET("sse2") inline __m128i bytesEqual(const uint8_t* p, __m128i value) {
+    return _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), value);
+}
+}
+
+SOS_TARGET("sse2")
+int countFramedTriplesSSE2(const uint8_t* cells, int size, int stride) {
+    int steps[4];
+    framedSteps(stride, steps);
+    const __m128i sv = _mm_set1_epi8(static_cast<char>(S));
+    const __m128i ov = _mm_set1_epi8(static_cast<char>(O));
+    const __m128i zero = _mm_setzero_si128();
+    __m128i total = zero;
+    int count = 0;
+
+    for (int row = 0; row < size; row++) {
+        const uint8_t* r = framedRow(cells, stride, row);
+        int col = 0;
+        for (; col + 16 <= size; col += 16) {
+            const uint8_t* c = r + col;
+            __m128i isS = bytesEqual(c, sv);
+            // Each matching line subtracts -1 from its cell's byte: 0..4
+            __m128i hits = zero;
+            for (int line = 0; line < 4; line++) {
+                int d = steps[line];
+                __m128i match = _mm_and_si128(bytesEqual(c + d, ov), bytesEqual(c + 2 * d, sv));
+                hits = _mm_sub_epi8(hits, _mm_and_si128(isS, match));
+            }
+            total = _mm_add_epi64(total, _mm_sad_epu8(hits, zero));
+        }
+        count += framedRun(r, col, size, steps);
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), total);
+    return count + static_cast<int>(lanes[0] + lanes[1]);
+}
+
+// Same loop as the scalar reference, compiled to use the POPCNT instruction
+SOS_TARGET("popcnt")
+int countTriplesPopcnt(const uint64_t* s, const uint64_t* o, int words) {
+    int count = 0;
+    for (int w = 0; w < words; w++) {
+        count += popcount64(tripleWord(s, o, w, words));
+    }
+    return count;
+}
+
+namespace {
+// Per 64-bit lane popcount with the nibble lookup (vpshufb) method
+SOS_TARGET("avx2") inline __m256i popcountLanes256(__m256i x) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(x, low));
+    __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(x, 4), low));
+    return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+}
+
+SOS_TARGET("avx2")
+int countTriplesAVX2(const uint64_t* s, const uint64_t* o, int words) {
+    __m256i total = _mm256_setzero_si256();
+    int w = 0;
+
+    for (; w + 4 < words; w += 4) {
+        __m256i sw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + w));
+        __m256i ow = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(o + w));
+        __m256i sn = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + w + 1));
+        __m256i on = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(o + w + 1));
+
+        __m256i o1 = _mm256_or_si256(_mm256_srli_epi64(ow, 1), _mm256_slli_epi64(on, 63));
+        __m256i s2 = _mm256_or_si256(_mm256_srli_epi64(sw, 2), _mm256_slli_epi64(sn, 62));
+        total = _mm256_add_epi64(total,
+                                 popcountLanes256(_mm256_and_si256(sw, _mm256_and_si256(o1, s2))));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), total);
+    int count = static_cast<int>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+
+    for (; w < words; w++) {
+        count += popcount64(tripleWord(s, o, w, words));
+    }
+    return count;
+}
+
+namespace {
+SOS_TARGET("avx2") inline __m256i bytesEqual256(const uint8_t* p, __m256i value) {
+    return _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), value);
+}
+}
+
+SOS_TARGET("avx2")
+int countFramedTriplesAVX2(const uint8_t* cells, int size, int stride) {
+    int steps[4];
+    framedSteps(stride, steps);
+    const __m256i sv = _mm256_set1_epi8(static_cast<char>(S));
+    const __m256i ov = _mm256_set1_epi8(static_cast<char>(O));
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i total = zero;
+    int count = 0;
+
+    for (int row = 0; row < size; row++) {
+        const uint8_t* r = framedRow(cells, stride, row);
+        int col = 0;
+        for (; col + 32 <= size; col += 32) {
+            const uint8_t* c = r + col;
+            __m256i isS = bytesEqual256(c, sv);
+            __m256i hits = zero;
+            for (int line = 0; line < 4; line++) {
+                int d = steps[line];
+                __m256i match =
+                    _mm256_and_si256(bytesEqual256(c + d, ov), bytesEqual256(c + 2 * d, sv));
+                hits = _mm256_sub_epi8(hits, _mm256_and_si256(isS, match));
+            }
+            total = _mm256_add_epi64(total, _mm256_sad_epu8(hits, zero));
+        }
+        count += framedRun(r, col, size, steps);
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), total);
+    return count + static_cast<int>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+}
+
+// GCC's AVX-512 headers seed unmasked results with self-initialised
+// placeholders, which trips the uninitialised warnings at -O2
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace {
+// The AVX2 lookup widened to 512 bits; vpshufb and vpsadbw on zmm need BW
+SOS_TARGET("avx512f,avx512bw") inline __m512i popcountLanes512(__m512i x) {
+    const __m512i lookup = _mm512_broadcast_i32x4(
+        _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4));
+    const __m512i low = _mm512_set1_epi8(0x0F);
+    __m512i lo = _mm512_shuffle_epi8(lookup, _mm512_and_si512(x, low));
+    __m512i hi = _mm512_shuffle_epi8(lookup, _mm512_and_si512(_mm512_srli_epi16(x, 4), low));
+    return _mm512_sad_epu8(_mm512_add_epi8(lo, hi), _mm512_setzero_si512());
+}
+}
+
+SOS_TARGET("avx512f,avx512bw")
+int countTriplesAVX512(const uint64_t* s, const uint64_t* o, int words) {
+    __m512i total = _mm512_setzero_si512();
+    int w = 0;
+
+    for (; w + 8 < words; w += 8) {
+        __m512i sw = _mm512_loadu_si512(s + w);
+        __m512i ow = _mm512_loadu_si512(o + w);
+        __m512i sn = _mm512_loadu_si512(s + w + 1);
+        __m512i on = _mm512_loadu_si512(o + w + 1);
+
+        __m512i o1 = _mm512_or_si512(_mm512_srli_epi64(ow, 1), _mm512_slli_epi64(on, 63));
+        __m512i s2 = _mm512_or_si512(_mm512_srli_epi64(sw, 2), _mm512_slli_epi64(sn, 62));
+        total = _mm512_add_epi64(total,
+                                 popcountLanes512(_mm512_and_si512(sw, _mm512_and_si512(o1, s2))));
+    }
+
+    int count = static_cast<int>(_mm512_reduce_add_epi64(total));
+    for (; w < words; w++) {
+        count += popcount64(tripleWord(s, o, w, words));
+    }
+    return count;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+CountTriplesFn countTriplesFor(SimdLevel level) {
+#if defined(SOS_X86)
+    switch (level) {
+    case SimdLevel::AVX512: return &countTriplesAVX512;
+    case SimdLevel::AVX2:   return &countTriplesAVX2;
+    case SimdLevel::SSE42:  return &countTriplesPopcnt;
+    case SimdLevel::SSE2:   return &countTriplesSSE2;
+    default:                break;
+    }
+#else
+    (void)level;
+#endif
+    return &countTriplesScalar;
+}
+
+int countTriples(const uint64_t* s, const uint64_t* o, int words) {
+    static const CountTriplesFn kernel = countTriplesFor(activeSimdLevel());
+    return kernel(s, o, words);
+}
+
+CountFramedTriplesFn countFramedTriplesFor(SimdLevel level) {
+#if defined(SOS_X86)
+    // Byte compares gain nothing from POPCNT; AVX-512 runs the AVX2 loop
+    switch (level) {
+    case SimdLevel::AVX512:
+    case SimdLevel::AVX2:   return &countFramedTriplesAVX2;
+    case SimdLevel::SSE42:
+    case SimdLevel::SSE2:   return &countFramedTriplesSSE2;
+    default:                break;
+    }
+#else
+    (void)level;
+#endif
+    return &countFramedTriplesScalar;
+}
+
+int countFramedTriples(const uint8_t* cells, int size, int stride) {
+    static const CountFramedTriplesFn kernel = countFramedTriplesFor(activeSimdLevel());
+    return kernel(cells, size, stride);
+}
+
+}
@@ -0,0 +1,74 @@
+#ifndef SOSKERNELS_H
+#define SOSKERNELS_H
+
+#include <cstdint>
+#include "enums.h"
+#include "cpudispatch.h"
+
+// Whole-board SOS counting over one Board::LineView. For every bit i the
+// kernels test S[i] & O[i + 1] & S[i + 2], i.e. the S mask against the O
+// mask shifted by one cell and the S mask shifted by two, and popcount
+// the result. Word w + 1 supplies the bits shifted in at the top of word w.
+namespace soskernels {
+
+// SOS a letter at 'index' would complete on a buffer in Board's framed
+// layout (BORDER two cells deep, so no bounds checks); 'steps' are the
+// buffer offsets along the four lines.
+inline int sosAt(const uint8_t* cells, int index, CellState letter, const int* steps) {
+    const uint8_t S = static_cast<uint8_t>(CellState::S);
+    const uint8_t O = static_cast<uint8_t>(CellState::O);
+    const uint8_t* c = cells + index;
+    int count = 0;
+    for (int line = 0; line < 4; line++) {
+        int d = steps[line];
+        if (letter == CellState::S) {
+            count += ((c[-d] == O) & (c[-2 * d] == S)) + ((c[d] == O) & (c[2 * d] == S));
+        } else {
+            count += (c[-d] == S) & (c[d] == S);
+        }
+    }
+    return count;
+}
+
+typedef int (*CountTriplesFn)(const uint64_t* s, const uint64_t* o, int words);
+
+// Portable reference
+int countTriplesScalar(const uint64_t* s, const uint64_t* o, int words);
+
+#if defined(SOS_X86)
+// Each needs the matching SimdLevel; see countTriplesFor
+int countTriplesSSE2(const uint64_t* s, const uint64_t* o, int words);
+int countTriplesPopcnt(const uint64_t* s, const uint64_t* o, int words);
+int countTriplesAVX2(const uint64_t* s, const uint64_t* o, int words);
+int countTriplesAVX512(const uint64_t* s, const uint64_t* o, int words);
+#endif
+
+// Fastest kernel that needs no more than 'level'
+CountTriplesFn countTriplesFor(SimdLevel level);
+
+// Kernel for activeSimdLevel(), selected once
+int countTriples(const uint64_t* s, const uint64_t* o, int words);
+
+// The same whole-board count straight off a buffer in Board's framed
+// layout, for boards that keep no line views: each cell's byte is
+// compared with the bytes one and two steps along every line, 16 or 32
+// cells per step. Rows are vectorised only up to their last full block so
+// no lane reaches into the next row; the rest of each row runs scalar.
+typedef int (*CountFramedTriplesFn)(const uint8_t* cells, int size, int stride);
+
+int countFramedTriplesScalar(const uint8_t* cells, int size, int stride);
+
+#if defined(SOS_X86)
+int countFramedTriplesSSE2(const uint8_t* cells, int size, int stride);
+int countFramedTriplesAVX2(const uint8_t* cells, int size, int stride);
+#endif
+
+// Fastest framed kernel that needs no more than 'level'
+CountFramedTriplesFn countFramedTriplesFor(SimdLevel level);
+
+// Framed kernel for activeSimdLevel(), selected once
+int countFramedTriples(const uint8_t* cells, int size, int stride);
+
+}
+
+#endif // SOSKERNELS_H
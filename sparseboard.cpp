@@ -0,0 +1,148 @@
+#include "sparseboard.h"
+
+SparseBoard::SparseBoard(int boardSize) : size(boardSize), placed(0) {
+    if (boardSize < 3) {
+        size = 3; // Minimum valid size
+    }
+}
+
+SparseBoard::SparseBoard(const SparseBoard& other) : size(other.size), placed(other.placed) {
+    for (const auto& entry : other.tiles) {
+        tiles[entry.first] = std::make_unique<Tile>(*entry.second);
+    }
+}
+
+SparseBoard& SparseBoard::operator=(const SparseBoard& other) {
+    if (this != &other) {
+        SparseBoard copy(other);
+        size = copy.size;
+        placed = copy.placed;
+        tiles.swap(copy.tiles);
+    }
+    return *this;
+}
+
+const SparseBoard::Tile* SparseBoard::findTile(int row, int col) const {
+    auto it = tiles.find(tileKey(row >> TILE_BITS, col >> TILE_BITS));
+    return it == tiles.end() ? nullptr : it->second.get();
+}
+
+SparseBoard::Tile* SparseBoard::findTile(int row, int col) {
+    auto it = tiles.find(tileKey(row >> TILE_BITS, col >> TILE_BITS));
+    return it == tiles.end() ? nullptr : it->second.get();
+}
+
+int SparseBoard::getSize() const {
+    return size;
+}
+
+CellState SparseBoard::getCell(int row, int col) const {
+    if (row < 0 || row >= size || col < 0 || col >= size) {
+        return CellState::EMPTY;
+    }
+    const Tile* tile = findTile(row, col);
+    if (!tile) {
+        return CellState::EMPTY;
+    }
+    int offset = (row & (TILE_SIZE - 1)) * TILE_SIZE + (col & (TILE_SIZE - 1));
+    return static_cast<CellState>((*tile)[offset]);
+}
+
+bool SparseBoard::isEmpty(int row, int col) const {
+    return getCell(row, col) == CellState::EMPTY;
+}
+
+bool SparseBoard::isFull() const {
+    return emptyCount() == 0;
+}
+
+long long SparseBoard::emptyCount() const {
+    return static_cast<long long>(size) * size - placed;
+}
+
+int SparseBoard::tileCount() const {
+    return static_cast<int>(tiles.size());
+}
+
+bool SparseBoard::makeMove(int row, int col, char letter) {
+    if (row < 0 || row >= size || col < 0 || col >= size) {
+        return false;
+    }
+    if (letter != 'S' && letter != 'O') {
+        return false;
+    }
+
+    // A missing tile means the cell is empty, so the move is known to
+    // succeed before a tile is allocated for it
+    int offset = (row & (TILE_SIZE - 1)) * TILE_SIZE + (col & (TILE_SIZE - 1));
+    Tile* tile = findTile(row, col);
+    if (tile && (*tile)[offset] != static_cast<uint8_t>(CellState::EMPTY)) {
+        return false;
+    }
+    if (!tile) {
+        std::unique_ptr<Tile>& slot = tiles[tileKey(row >> TILE_BITS, col >> TILE_BITS)];
+        slot = std::make_unique<Tile>();
+        slot->fill(static_cast<uint8_t>(CellState::EMPTY));
+        tile = slot.get();
+    }
+
+    (*tile)[offset] = static_cast<uint8_t>(letter == 'S' ? CellState::S : CellState::O);
+    placed++;
+    return true;
+}
+
+int SparseBoard::checkForSOS(int row, int col) const {
+    int count = 0;
+    CellState placedLetter = getCell(row, col);
+    if (placedLetter == CellState::EMPTY) {
+        return 0;
+    }
+
+    // When the whole 5x5 neighbourhood sits inside one tile, read the tile
+    // directly; near tile edges go through getCell, which finds the
+    // neighbouring tile (or treats a missing one as empty)
+    int localRow = row & (TILE_SIZE - 1);
+    int localCol = col & (TILE_SIZE - 1);
+    const Tile* tile = nullptr;
+    if (localRow >= 2 && localRow < TILE_SIZE - 2 && localCol >= 2 && localCol < TILE_SIZE - 2) {
+        tile = findTile(row, col);
+    }
+
+    auto at = [&](int r, int c) {
+        if (tile) {
+            return static_cast<CellState>((*tile)[(r & (TILE_SIZE - 1)) * TILE_SIZE +
+                                                  (c & (TILE_SIZE - 1))]);
+        }
+        return getCell(r, c);
+    };
+
+    int lines[4][2] = {{0, 1}, {1, 0}, {1, 1}, {-1, 1}};
+
+    for (int i = 0; i < 4; i++) {
+        int dr = lines[i][0];
+        int dc = lines[i][1];
+
+        if (placedLetter == CellState::S) {
+            // S completes the triple as either end
+            for (int sign = -1; sign <= 1; sign += 2) {
+                if (at(row + sign * dr, col + sign * dc) == CellState::O &&
+                    at(row + 2 * sign * dr, col + 2 * sign * dc) == CellState::S) {
+                    count++;
+                }
+            }
+        } else {
+            // O completes the triple as the middle
+            if (at(row - dr, col - dc) == CellState::S &&
+                at(row + dr, col + dc) == CellState::S) {
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+void SparseBoard::reset() {
+    tiles.clear();
+    placed = 0;
+}
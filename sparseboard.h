@@ -0,0 +1,48 @@
+#ifndef SPARSEBOARD_H
+#define SPARSEBOARD_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include "enums.h"
+
+// Board for very large sizes where only a small region is played.
+// Cells live in 64x64 tiles that are allocated on the first move inside
+// them, so memory grows with the moves played rather than with size^2.
+class SparseBoard {
+public:
+    static const int TILE_BITS = 6;
+    static const int TILE_SIZE = 1 << TILE_BITS;   // 64 cells per side
+
+private:
+    typedef std::array<uint8_t, TILE_SIZE * TILE_SIZE> Tile;
+
+    int size;
+    long long placed;
+    std::unordered_map<uint64_t, std::unique_ptr<Tile>> tiles;
+
+    static uint64_t tileKey(int tileRow, int tileCol) {
+        return (static_cast<uint64_t>(tileRow) << 32) | static_cast<uint32_t>(tileCol);
+    }
+    const Tile* findTile(int row, int col) const;
+    Tile* findTile(int row, int col);
+
+public:
+    SparseBoard(int boardSize = 8);
+    SparseBoard(const SparseBoard& other);
+    SparseBoard& operator=(const SparseBoard& other);
+
+    int getSize() const;
+    CellState getCell(int row, int col) const;
+    bool isEmpty(int row, int col) const;
+    bool isFull() const;
+    long long emptyCount() const;
+    int tileCount() const;
+
+    bool makeMove(int row, int col, char letter);
+    int checkForSOS(int row, int col) const;
+    void reset();
+};
+
+#endif // SPARSEBOARD_H
@@ -3,6 +3,65 @@
 #include "board.h"
 #include "game.h"
 #include "player.h"
+#include "packedboard.h"
+#include "sparseboard.h"
+#include "zobrist.h"
+#include "soskernels.h"
+#include "boardanalysis.h"
+#include "layoutboard.h"
+#include "engine.h"
+#include "search.h"
+#include "transtable.h"
+#include "mcts.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <tuple>
+
+// Reference SOS count by walking every triple through getCell
+static int bruteForceCountSOS(const Board& board) {
+    int n = board.getSize();
+    int dirs[4][2] = {{0, 1}, {1, 0}, {1, 1}, {-1, 1}};
+    int count = 0;
+    for (int r = 0; r < n; r++) {
+        for (int c = 0; c < n; c++) {
+            for (auto& d : dirs) {
+                int r2 = r + 2 * d[0], c2 = c + 2 * d[1];
+                if (r2 < 0 || r2 >= n || c2 < 0 || c2 >= n) continue;
+                if (board.getCell(r, c) == CellState::S &&
+                    board.getCell(r + d[0], c + d[1]) == CellState::O &&
+                    board.getCell(r2, c2) == CellState::S) {
+                    count++;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+// Reference SOS count for 'letter' at an empty or occupied cell, scanning
+// the 8 directions through getCell like the original checkForSOS: an S
+// completes S-O-S as an end, an O as the middle of each line
+static int bruteForceSOSAt(const Board& board, int row, int col, CellState letter) {
+    int n = board.getSize();
+    auto at = [&](int r, int c) {
+        return (r >= 0 && r < n && c >= 0 && c < n) ? board.getCell(r, c) : CellState::EMPTY;
+    };
+    int directions[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}};
+    int count = 0;
+    for (auto& d : directions) {
+        if (letter == CellState::S) {
+            count += at(row + d[0], col + d[1]) == CellState::O &&
+                     at(row + 2 * d[0], col + 2 * d[1]) == CellState::S;
+        } else if (d[0] > 0 || (d[0] == 0 && d[1] > 0)) {
+            // Each line once for the middle letter
+            count += at(row + d[0], col + d[1]) == CellState::S &&
+                     at(row - d[0], col - d[1]) == CellState::S;
+        }
+    }
+    return count;
+}
 
 // Tests
 
@@ -210,6 +269,30 @@ TEST_CASE("Computer makes valid moves", "[computer][sprint4]") {
     }
 }
 
+TEST_CASE("Choosing a computer move leaves the game untouched", "[computer]") {
+    Game game(5, GameMode::SIMPLE);
+    game.setupPlayers("AI", PlayerType::AI, "Human", PlayerType::HUMAN);
+    game.makeMove(2, 2);
+    game.makeMove(0, 0);
+    Player* mover = game.getCurrentPlayer();
+    uint64_t hash = game.getBoard().hash();
+
+    EngineMove move;
+    REQUIRE(game.chooseComputerMove(move));
+    REQUIRE(game.getBoard().hash() == hash);
+    REQUIRE(game.getBoard().emptyCount() == 23);
+    REQUIRE(game.getCurrentPlayer() == mover);
+    REQUIRE(game.getBoard().isEmpty(move.row, move.col));
+
+    REQUIRE(game.playComputerMove(move));
+    REQUIRE(game.getBoard().getCell(move.row, move.col) ==
+            (move.letter == 'S' ? CellState::S : CellState::O));
+    REQUIRE(mover->getCurrentLetter() == move.letter);
+
+    // An occupied cell is refused, as it is from makeMove
+    REQUIRE_FALSE(game.playComputerMove(move));
+}
+
 TEST_CASE("Computer makes multiple valid moves", "[computer][sprint4]") {
     Game game(5, GameMode::GENERAL);
     game.setupPlayers("AI 1", PlayerType::AI, "AI 2", PlayerType::AI);
@@ -331,3 +414,1343 @@ TEST_CASE("Moves are not recorded when recording is off", "[recording][sprint5]"
         REQUIRE(moves.size() == 1);  // Only first move recorded
     }
 }
+
+TEST_CASE("Board cell storage", "[board]") {
+    Board board(4);
+
+    SECTION("Cells start empty") {
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                REQUIRE(board.getCell(i, j) == CellState::EMPTY);
+            }
+        }
+    }
+
+    SECTION("Moves land in the right cell") {
+        REQUIRE(board.makeMove(1, 2, 'S') == true);
+        REQUIRE(board.makeMove(3, 0, 'O') == true);
+        REQUIRE(board.getCell(1, 2) == CellState::S);
+        REQUIRE(board.getCell(3, 0) == CellState::O);
+        REQUIRE(board.getCell(2, 1) == CellState::EMPTY);
+        REQUIRE(board.makeMove(1, 2, 'O') == false);
+    }
+
+    SECTION("Out of range reads are empty") {
+        REQUIRE(board.getCell(-1, 0) == CellState::EMPTY);
+        REQUIRE(board.getCell(0, 4) == CellState::EMPTY);
+    }
+
+    SECTION("Reset clears every cell") {
+        board.makeMove(0, 0, 'S');
+        board.makeMove(3, 3, 'O');
+        board.reset();
+        REQUIRE(board.isEmpty(0, 0));
+        REQUIRE(board.isEmpty(3, 3));
+        REQUIRE(board.isFull() == false);
+    }
+}
+
+TEST_CASE("Board occupancy bitboards", "[board][bitboard]") {
+    Board board(10, Board::TRACK_LINE_VIEWS);  // 100 cells, spans two words
+
+    SECTION("Empty count tracks moves") {
+        REQUIRE(board.emptyCount() == 100);
+        board.makeMove(0, 0, 'S');
+        board.makeMove(9, 9, 'O');
+        board.makeMove(6, 4, 'S');  // bit 64, first bit of the second word
+        REQUIRE(board.emptyCount() == 97);
+        const Board::LineView& rows = board.getView(Board::HORIZONTAL);
+        REQUIRE(rows.s.count() == 2);
+        REQUIRE(rows.o.count() == 1);
+        REQUIRE(rows.s.test(board.viewPos(Board::HORIZONTAL, 6, 4)));
+        REQUIRE(board.isEmpty(6, 4) == false);
+    }
+
+    SECTION("Full board is detected") {
+        for (int i = 0; i < 10; i++) {
+            for (int j = 0; j < 10; j++) {
+                REQUIRE(board.isFull() == false);
+                board.makeMove(i, j, (i + j) % 2 ? 'S' : 'O');
+            }
+        }
+        REQUIRE(board.isFull() == true);
+        REQUIRE(board.emptyCount() == 0);
+
+        board.reset();
+        REQUIRE(board.emptyCount() == 100);
+        REQUIRE(board.getView(Board::DIAGONAL).s.any() == false);
+    }
+}
+
+TEST_CASE("Line view SOS detection matches a full recount", "[board][bitboard]") {
+    // Views kept up to date, and built for each count
+    for (unsigned tracking : {unsigned(Board::TRACK_LINE_VIEWS), 0u}) {
+        srand(449);
+        for (int n = 3; n <= 13; n++) {
+            Board board(n, tracking);
+            int total = 0;
+            for (int moves = 0; moves < n * n; moves++) {
+                int row = rand() % n;
+                int col = rand() % n;
+                if (!board.isEmpty(row, col)) continue;
+
+                char letter = (rand() % 3 == 0) ? 'O' : 'S';
+                int predicted = board.checkForSOS(row, col, letter);
+                REQUIRE(board.makeMove(row, col, letter));
+                REQUIRE(board.checkForSOS(row, col) == predicted);
+
+                total += predicted;
+                REQUIRE(board.countAllSOS() == total);
+                if (moves % 5 == 4) {
+                    // Unmake keeps the views in step too
+                    board.unmakeMove(row, col);
+                    total -= predicted;
+                    REQUIRE(board.countAllSOS() == total);
+                }
+            }
+            REQUIRE(bruteForceCountSOS(board) == total);
+        }
+    }
+}
+
+TEST_CASE("SOS on every line direction", "[board][bitboard]") {
+    Board board(5);
+
+    SECTION("Vertical") {
+        board.makeMove(1, 4, 'S');
+        board.makeMove(3, 4, 'S');
+        REQUIRE(board.checkForSOS(2, 4, 'O') == 1);
+    }
+
+    SECTION("Both diagonals through one O") {
+        board.makeMove(0, 0, 'S');
+        board.makeMove(2, 2, 'S');
+        board.makeMove(0, 2, 'S');
+        board.makeMove(2, 0, 'S');
+        board.makeMove(1, 1, 'O');
+        REQUIRE(board.checkForSOS(1, 1) == 2);
+        REQUIRE(board.countAllSOS() == 2);
+    }
+
+    SECTION("No match across the row boundary") {
+        board.makeMove(0, 3, 'S');
+        board.makeMove(0, 4, 'O');
+        REQUIRE(board.checkForSOS(1, 0, 'S') == 0);
+    }
+}
+
+TEST_CASE("Board maintains the empty cell set", "[board]") {
+    std::mt19937 rng(4);
+    Board board(6);
+    REQUIRE(board.emptyCount() == 36);
+
+    board.makeMove(2, 3, 'S');
+    board.makeMove(0, 0, 'O');
+    board.makeMove(5, 5, 'S');
+    REQUIRE(board.emptyCount() == 33);
+
+    SECTION("Set holds exactly the empty cells") {
+        int seen = 0;
+        for (int i = 0; i < board.emptyCount(); i++) {
+            int row, col;
+            board.emptyCellAt(i, row, col);
+            REQUIRE(board.isEmpty(row, col));
+            seen++;
+        }
+        REQUIRE(seen == 33);
+    }
+
+    SECTION("Random pick is always empty") {
+        for (int i = 0; i < 50; i++) {
+            int row, col;
+            REQUIRE(board.randomEmptyCell(row, col, rng));
+            REQUIRE(board.isEmpty(row, col));
+        }
+    }
+
+    SECTION("Full and reset") {
+        for (int i = 0; i < 6; i++) {
+            for (int j = 0; j < 6; j++) {
+                board.makeMove(i, j, 'O');
+            }
+        }
+        int row, col;
+        REQUIRE(board.isFull());
+        REQUIRE(board.randomEmptyCell(row, col, rng) == false);
+
+        board.reset();
+        REQUIRE(board.emptyCount() == 36);
+        REQUIRE(board.makeMove(2, 3, 'S'));
+        REQUIRE(board.emptyCount() == 35);
+    }
+}
+
+TEST_CASE("Packed board matches Board", "[board][packed]") {
+    srand(5);
+    std::mt19937 rng(5);
+    for (int n = 3; n <= 11; n += 4) {
+        Board board(n);
+        PackedBoard packed(n);
+
+        while (!board.isFull()) {
+            int row, col;
+            board.randomEmptyCell(row, col, rng);
+            char letter = (rand() % 2) ? 'S' : 'O';
+
+            REQUIRE(board.makeMove(row, col, letter));
+            REQUIRE(packed.makeMove(row, col, letter));
+            REQUIRE(packed.makeMove(row, col, 'S') == false);
+            REQUIRE(packed.getCell(row, col) == board.getCell(row, col));
+            REQUIRE(packed.checkForSOS(row, col) == board.checkForSOS(row, col));
+            REQUIRE(packed.emptyCount() == board.emptyCount());
+            REQUIRE(packed.isFull() == board.isFull());
+        }
+
+        packed.reset();
+        REQUIRE(packed.emptyCount() == n * n);
+        REQUIRE(packed.isFull() == false);
+    }
+}
+
+TEST_CASE("Packed board uses 2 bits per cell", "[board][packed]") {
+    PackedBoard packed(4096);
+    REQUIRE(packed.memoryBytes() == 4096u * 4096u / 4u);
+    REQUIRE(packed.emptyCount() == 4096LL * 4096LL);
+
+    REQUIRE(packed.makeMove(4095, 4095, 'O'));
+    REQUIRE(packed.getCell(4095, 4095) == CellState::O);
+    REQUIRE(packed.emptyCount() == 4096LL * 4096LL - 1);
+}
+
+TEST_CASE("Sparse board allocates tiles lazily", "[board][sparse]") {
+    SparseBoard board(1000000);
+    REQUIRE(board.tileCount() == 0);
+    REQUIRE(board.isEmpty(999999, 999999));
+
+    REQUIRE(board.makeMove(500000, 500000, 'S'));
+    REQUIRE(board.makeMove(999999, 0, 'O'));
+    REQUIRE(board.tileCount() == 2);
+    REQUIRE(board.emptyCount() == 1000000LL * 1000000LL - 2);
+    REQUIRE(board.makeMove(1000000, 0, 'S') == false);
+
+    // Rejected moves allocate nothing
+    REQUIRE(board.makeMove(500000, 500000, 'O') == false);
+    REQUIRE(board.makeMove(0, 0, 'X') == false);
+    REQUIRE(board.tileCount() == 2);
+
+    board.reset();
+    REQUIRE(board.tileCount() == 0);
+    REQUIRE(board.isEmpty(500000, 500000));
+}
+
+TEST_CASE("Sparse board finds SOS across tile boundaries", "[board][sparse]") {
+    SparseBoard board(200);
+
+    SECTION("Horizontal across a vertical tile edge") {
+        board.makeMove(10, 63, 'S');
+        board.makeMove(10, 65, 'S');
+        board.makeMove(10, 64, 'O');
+        REQUIRE(board.checkForSOS(10, 64) == 1);
+    }
+
+    SECTION("Diagonal across a tile corner") {
+        board.makeMove(62, 62, 'S');
+        board.makeMove(63, 63, 'O');
+        board.makeMove(64, 64, 'S');
+        REQUIRE(board.checkForSOS(64, 64) == 1);
+        REQUIRE(board.tileCount() == 2);
+    }
+
+    SECTION("Matches Board on a random game") {
+        srand(6);
+        std::mt19937 rng(6);
+        Board reference(70);
+        SparseBoard sparse(70);
+        for (int i = 0; i < 3000; i++) {
+            int row, col;
+            reference.randomEmptyCell(row, col, rng);
+            char letter = (rand() % 2) ? 'S' : 'O';
+            reference.makeMove(row, col, letter);
+            sparse.makeMove(row, col, letter);
+            REQUIRE(sparse.checkForSOS(row, col) == reference.checkForSOS(row, col));
+        }
+    }
+}
+
+TEST_CASE("Board hash follows the position", "[board][hash]") {
+    Board a(5);
+    Board b(5);
+    uint64_t emptyKey = a.hash();
+
+    SECTION("Move order does not matter") {
+        a.makeMove(0, 0, 'S');
+        a.makeMove(2, 3, 'O');
+        b.makeMove(2, 3, 'O');
+        b.makeMove(0, 0, 'S');
+        REQUIRE(a.hash() == b.hash());
+        REQUIRE(a.hash() != emptyKey);
+    }
+
+    SECTION("Letter and size are part of the key") {
+        a.makeMove(1, 1, 'S');
+        b.makeMove(1, 1, 'O');
+        REQUIRE(a.hash() != b.hash());
+        REQUIRE(Board(5).hash() != Board(6).hash());
+    }
+
+    SECTION("Reset restores the empty key") {
+        a.makeMove(4, 4, 'S');
+        a.reset();
+        REQUIRE(a.hash() == emptyKey);
+    }
+}
+
+TEST_CASE("Game position key includes side to move and mode", "[game][hash]") {
+    Game game(4, GameMode::GENERAL);
+    uint64_t start = game.positionKey();
+    REQUIRE(start != Game(4, GameMode::SIMPLE).positionKey());
+
+    game.getCurrentPlayer()->setCurrentLetter('S');
+    game.makeMove(0, 0);  // no SOS, player 2 to move
+    uint64_t boardOnly = game.getBoard().hash() ^ zobrist::GENERAL_KEY;
+    REQUIRE(game.positionKey() == (boardOnly ^ zobrist::SIDE_KEY));
+
+    game.newGame(4, GameMode::GENERAL);
+    REQUIRE(game.positionKey() == start);
+}
+
+TEST_CASE("Unmake restores the game step by step", "[game][undo]") {
+    struct Snapshot {
+        uint64_t key;
+        int p1Score;
+        int p2Score;
+        GameState state;
+        size_t recorded;
+        int empty;
+    };
+
+    for (GameMode mode : {GameMode::SIMPLE, GameMode::GENERAL}) {
+        Game game(5, mode);
+        game.setupPlayers("AI 1", PlayerType::AI, "AI 2", PlayerType::AI);
+        game.startRecording();
+
+        std::vector<Snapshot> history;
+        while (game.getState() == GameState::ONGOING) {
+            history.push_back({game.positionKey(), game.getPlayer1()->getScore(),
+                               game.getPlayer2()->getScore(), game.getState(),
+                               game.getRecordedMoves().size(), game.getBoard().emptyCount()});
+            REQUIRE(game.makeComputerMove());
+        }
+
+        while (!history.empty()) {
+            char letter = game.getRecordedMoves().back().letter;
+            REQUIRE(game.unmakeMove());
+            // The mover is back on turn with the letter they played
+            REQUIRE(game.getCurrentPlayer()->getCurrentLetter() == letter);
+            const Snapshot& snap = history.back();
+            REQUIRE(game.positionKey() == snap.key);
+            REQUIRE(game.getPlayer1()->getScore() == snap.p1Score);
+            REQUIRE(game.getPlayer2()->getScore() == snap.p2Score);
+            REQUIRE(game.getState() == snap.state);
+            REQUIRE(game.getRecordedMoves().size() == snap.recorded);
+            REQUIRE(game.getBoard().emptyCount() == snap.empty);
+            history.pop_back();
+        }
+
+        REQUIRE(game.unmakeMove() == false);
+        REQUIRE(game.getCurrentPlayer() == game.getPlayer1());
+        REQUIRE(game.getBoard().countAllSOS() == 0);
+    }
+}
+
+TEST_CASE("Symmetric positions share a canonical key", "[board][hash]") {
+    const int n = 6;
+    Board original(n, Board::TRACK_SYMMETRY);
+    original.makeMove(0, 1, 'S');
+    original.makeMove(2, 4, 'O');
+    original.makeMove(5, 3, 'S');
+
+    for (int sym = 0; sym < 8; sym++) {
+        Board image(n, Board::TRACK_SYMMETRY);
+        for (auto move : {std::make_tuple(0, 1, 'S'), std::make_tuple(2, 4, 'O'),
+                          std::make_tuple(5, 3, 'S')}) {
+            int r, c;
+            Board::transformCell(sym, n, std::get<0>(move), std::get<1>(move), r, c);
+            image.makeMove(r, c, std::get<2>(move));
+        }
+        REQUIRE(image.canonicalKey() == original.canonicalKey());
+        REQUIRE((sym == 0) == (image.hash() == original.hash()));
+    }
+
+    SECTION("Moves map to the canonical position and back") {
+        int cr, cc, r, c;
+        original.toCanonical(2, 4, cr, cc);
+        original.fromCanonical(cr, cc, r, c);
+        REQUIRE(r == 2);
+        REQUIRE(c == 4);
+
+        // Replaying the canonical images gives the canonical hash
+        Board canonical(n);
+        original.toCanonical(0, 1, r, c);
+        canonical.makeMove(r, c, 'S');
+        original.toCanonical(2, 4, r, c);
+        canonical.makeMove(r, c, 'O');
+        original.toCanonical(5, 3, r, c);
+        canonical.makeMove(r, c, 'S');
+        REQUIRE(canonical.hash() == original.canonicalKey());
+    }
+
+    SECTION("Unmake keeps every symmetric key in step") {
+        uint64_t before = original.canonicalKey();
+        original.makeMove(3, 3, 'O');
+        original.unmakeMove(3, 3);
+        REQUIRE(original.canonicalKey() == before);
+    }
+
+    SECTION("Keys switched on mid-game match ones kept from the start") {
+        Board plain(n);
+        plain.makeMove(0, 1, 'S');
+        plain.makeMove(2, 4, 'O');
+        plain.makeMove(5, 3, 'S');
+        REQUIRE(plain.hash() == original.hash());
+        plain.setTracking(Board::TRACK_SYMMETRY);
+        REQUIRE(plain.canonicalKey() == original.canonicalKey());
+        REQUIRE(plain.canonicalSymmetry() == original.canonicalSymmetry());
+    }
+}
+
+TEST_CASE("Board frame never scores", "[board]") {
+    Board board(3);
+
+    SECTION("Edge cells read the frame, not the next row") {
+        REQUIRE(static_cast<uint8_t>(board.cellAt(0, -1)) == Board::BORDER);
+        REQUIRE(static_cast<uint8_t>(board.cellAt(-2, 4)) == Board::BORDER);
+        REQUIRE(board.getCell(0, -1) == CellState::EMPTY);
+    }
+
+    SECTION("Letters on the edge only score inside the board") {
+        board.makeMove(0, 1, 'O');
+        board.makeMove(1, 0, 'O');
+        board.makeMove(1, 1, 'O');
+        REQUIRE(board.checkForSOS(0, 0, 'S') == 0);
+        board.makeMove(0, 2, 'S');
+        board.makeMove(2, 2, 'S');
+        REQUIRE(board.checkForSOS(0, 0, 'S') == 2);
+    }
+
+    SECTION("Off-board cells never score, however far out") {
+        Board tracked(3, Board::TRACK_NEIGHBOURHOOD);
+        LayoutBoard<TiledLayout> tiled(3);
+        for (auto move : {std::make_tuple(0, 0, 'S'), std::make_tuple(0, 1, 'O')}) {
+            board.makeMove(std::get<0>(move), std::get<1>(move), std::get<2>(move));
+            tracked.makeMove(std::get<0>(move), std::get<1>(move), std::get<2>(move));
+            tiled.makeMove(std::get<0>(move), std::get<1>(move), std::get<2>(move));
+        }
+        for (auto cell : {std::make_pair(0, 3), std::make_pair(0, -1), std::make_pair(-20, 0),
+                          std::make_pair(0, 1000), std::make_pair(-1, -1000)}) {
+            for (char letter : {'S', 'O'}) {
+                REQUIRE(board.checkForSOS(cell.first, cell.second, letter) == 0);
+                REQUIRE(tracked.checkForSOS(cell.first, cell.second, letter) == 0);
+                REQUIRE(tiled.checkForSOS(cell.first, cell.second, letter) == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("Scoring lookups stay correct through unmake", "[board]") {
+    // With the code table and with the direct cell scan
+    for (unsigned tracking : {0u, unsigned(Board::TRACK_NEIGHBOURHOOD)}) {
+        srand(11);
+        std::mt19937 rng(11);
+        Board board(7, tracking);
+        for (int i = 0; i < 30; i++) {
+            int row, col;
+            board.randomEmptyCell(row, col, rng);
+            board.makeMove(row, col, (rand() % 2) ? 'S' : 'O');
+        }
+
+        // Take back a few letters, then check every prediction against a
+        // scan that doesn't use the neighbourhood codes
+        for (int i = 0; i < 10; i++) {
+            board.unmakeMove(rand() % 7, rand() % 7);
+        }
+        for (int r = 0; r < 7; r++) {
+            for (int c = 0; c < 7; c++) {
+                CellState placed = board.getCell(r, c);
+                if (placed == CellState::EMPTY) {
+                    REQUIRE(board.checkForSOS(r, c, 'S') == bruteForceSOSAt(board, r, c, CellState::S));
+                    REQUIRE(board.checkForSOS(r, c, 'O') == bruteForceSOSAt(board, r, c, CellState::O));
+                    REQUIRE(board.checkForSOS(r, c) == 0);
+                } else {
+                    REQUIRE(board.checkForSOS(r, c) == bruteForceSOSAt(board, r, c, placed));
+                    REQUIRE(board.checkForSOS(r, c, 'S') == 0);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("SOS count kernels agree", "[board][kernels]") {
+    srand(12);
+    std::mt19937 rng(12);
+
+    SECTION("Random masks of every length") {
+        for (int words = 1; words <= 19; words++) {
+            std::vector<uint64_t> s(words), o(words);
+            for (int w = 0; w < words; w++) {
+                uint64_t a = (static_cast<uint64_t>(rand()) << 33) ^ (static_cast<uint64_t>(rand()) << 11) ^ rand();
+                uint64_t b = (static_cast<uint64_t>(rand()) << 33) ^ (static_cast<uint64_t>(rand()) << 11) ^ rand();
+                s[w] = a & ~b;  // S and O never share a cell
+                o[w] = b & ~a;
+            }
+            int expected = soskernels::countTriplesScalar(s.data(), o.data(), words);
+
+            // Every level this CPU can run, from scalar up to the detected one
+            for (int level = 0; level <= static_cast<int>(detectedSimdLevel()); level++) {
+                soskernels::CountTriplesFn kernel =
+                    soskernels::countTriplesFor(static_cast<SimdLevel>(level));
+                REQUIRE(kernel(s.data(), o.data(), words) == expected);
+            }
+            REQUIRE(soskernels::countTriples(s.data(), o.data(), words) == expected);
+        }
+    }
+
+    SECTION("Whole board recount on a large board") {
+        Board board(40);
+        for (int i = 0; i < 1200; i++) {
+            int row, col;
+            board.randomEmptyCell(row, col, rng);
+            board.makeMove(row, col, (rand() % 3) ? 'S' : 'O');
+        }
+        REQUIRE(board.countAllSOS() == bruteForceCountSOS(board));
+        board.setTracking(Board::TRACK_LINE_VIEWS);
+        REQUIRE(board.countAllSOS() == bruteForceCountSOS(board));
+    }
+
+    SECTION("Cell buffer kernels at widths around every vector block") {
+        for (int n = 3; n <= 70; n++) {
+            Board board(n);
+            for (int i = 0; i < n * n * 2 / 3; i++) {
+                int row, col;
+                board.randomEmptyCell(row, col, rng);
+                board.makeMove(row, col, (rand() % 3) ? 'S' : 'O');
+            }
+            int expected = bruteForceCountSOS(board);
+            for (int level = 0; level <= static_cast<int>(detectedSimdLevel()); level++) {
+                soskernels::CountFramedTriplesFn kernel =
+                    soskernels::countFramedTriplesFor(static_cast<SimdLevel>(level));
+                REQUIRE(kernel(board.data(), n, board.getStride()) == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("Threat map matches a full rescan", "[board][threats]") {
+    srand(13);
+    std::mt19937 rng(13);
+    const int n = 9;
+    Board board(n, Board::TRACK_THREATS);
+
+    auto verify = [&]() {
+        int scoring = 0;
+        for (int r = 0; r < n; r++) {
+            for (int c = 0; c < n; c++) {
+                REQUIRE(board.sGain(r, c) == board.checkForSOS(r, c, 'S'));
+                REQUIRE(board.oGain(r, c) == board.checkForSOS(r, c, 'O'));
+                if (board.sGain(r, c) + board.oGain(r, c) > 0) {
+                    scoring++;
+                }
+            }
+        }
+        REQUIRE(board.scoringMoveCount() == scoring);
+        for (int i = 0; i < board.scoringMoveCount(); i++) {
+            int r, c;
+            board.scoringCellAt(i, r, c);
+            REQUIRE(board.isEmpty(r, c));
+            REQUIRE(board.sGain(r, c) + board.oGain(r, c) > 0);
+        }
+    };
+
+    for (int i = 0; i < 60; i++) {
+        int row, col;
+        board.randomEmptyCell(row, col, rng);
+        board.makeMove(row, col, (rand() % 2) ? 'S' : 'O');
+        if (i % 7 == 6) {
+            board.unmakeMove(row, col);
+        }
+        verify();
+    }
+
+    board.reset();
+    REQUIRE(board.scoringMoveCount() == 0);
+    verify();
+}
+
+TEST_CASE("Board reports completed SOS lines", "[board]") {
+    Board board(5);
+    Board::SOSLine lines[Board::MAX_SOS_PER_MOVE];
+
+    SECTION("O in the middle of two lines") {
+        board.makeMove(1, 1, 'S');
+        board.makeMove(3, 3, 'S');
+        board.makeMove(2, 1, 'S');
+        board.makeMove(2, 3, 'S');
+        board.makeMove(2, 2, 'O');
+
+        REQUIRE(board.findSOS(2, 2, lines, Board::MAX_SOS_PER_MOVE) == 2);
+        bool horizontal = false, diagonal = false;
+        for (int i = 0; i < 2; i++) {
+            if (lines[i].startRow == 2 && lines[i].startCol == 1 &&
+                lines[i].endRow == 2 && lines[i].endCol == 3) horizontal = true;
+            if (lines[i].startRow == 1 && lines[i].startCol == 1 &&
+                lines[i].endRow == 3 && lines[i].endCol == 3) diagonal = true;
+        }
+        REQUIRE(horizontal);
+        REQUIRE(diagonal);
+    }
+
+    SECTION("S closing lines on both sides") {
+        board.makeMove(0, 2, 'S');
+        board.makeMove(1, 2, 'O');
+        board.makeMove(3, 2, 'O');
+        board.makeMove(4, 2, 'S');
+        board.makeMove(2, 2, 'S');
+
+        REQUIRE(board.findSOS(2, 2, lines, Board::MAX_SOS_PER_MOVE) == 2);
+        REQUIRE(lines[0].startRow == 0);
+        REQUIRE(lines[0].endRow == 2);
+        REQUIRE(lines[1].startRow == 2);
+        REQUIRE(lines[1].endRow == 4);
+    }
+
+    SECTION("Count is exact even when the buffer is small") {
+        board.makeMove(0, 0, 'S');
+        board.makeMove(0, 1, 'O');
+        board.makeMove(1, 2, 'O');
+        board.makeMove(2, 2, 'S');
+        board.makeMove(1, 1, 'O');
+        board.makeMove(2, 0, 'S');
+        board.makeMove(0, 2, 'S');
+
+        REQUIRE(board.findSOS(0, 2, lines, 1) == 3);
+        REQUIRE(board.checkForSOS(0, 2) == 3);
+    }
+}
+
+// Plays one random game on both boards, checking every scoring query
+// along the way
+template <typename Other>
+static void compareWithBoard(Other& other, int n) {
+    std::mt19937 rng(static_cast<unsigned>(rand()));
+    Board board(n);
+
+    while (!board.isFull()) {
+        int row, col;
+        board.randomEmptyCell(row, col, rng);
+        char letter = (rand() % 2) ? 'S' : 'O';
+        REQUIRE(other.checkForSOS(row, col, letter) == board.checkForSOS(row, col, letter));
+
+        REQUIRE(other.makeMove(row, col, letter));
+        board.makeMove(row, col, letter);
+        REQUIRE(other.getCell(row, col) == board.getCell(row, col));
+        REQUIRE(other.checkForSOS(row, col) == board.checkForSOS(row, col));
+    }
+    REQUIRE(other.isFull());
+    REQUIRE(other.makeMove(0, 0, 'S') == false);
+
+    other.reset();
+    REQUIRE(other.emptyCount() == static_cast<long long>(n) * n);
+}
+
+TEST_CASE("Reset matches a fresh board however full", "[board][reset]") {
+    srand(20);
+    std::mt19937 rng(20);
+    const int n = 12;
+    Board board(n, Board::TRACK_THREATS | Board::TRACK_TRIPLES);
+    Board fresh(n, Board::TRACK_THREATS | Board::TRACK_TRIPLES);
+
+    // A few moves take the sparse path, a full board the refill
+    for (int moves : {1, 5, n * n / 2, n * n}) {
+        for (int i = 0; i < moves; i++) {
+            int row, col;
+            board.randomEmptyCell(row, col, rng);
+            board.makeMove(row, col, (rand() % 2) ? 'S' : 'O');
+        }
+        board.reset();
+
+        REQUIRE(board.emptyCount() == n * n);
+        REQUIRE(board.hash() == fresh.hash());
+        REQUIRE(board.scoringMoveCount() == 0);
+        REQUIRE(board.liveTripleCount() == fresh.liveTripleCount());
+        REQUIRE(board.nearCompleteTripleCount() == 0);
+        REQUIRE(board.completedTripleCount() == 0);
+        REQUIRE(board.countAllSOS() == 0);
+        for (int row = 0; row < n; row++) {
+            for (int col = 0; col < n; col++) {
+                REQUIRE(board.isEmpty(row, col));
+            }
+        }
+
+        // The reset board plays on exactly like a new one
+        board.makeMove(3, 3, 'S');
+        board.makeMove(3, 5, 'S');
+        fresh.makeMove(3, 3, 'S');
+        fresh.makeMove(3, 5, 'S');
+        REQUIRE(board.checkForSOS(3, 4, 'O') == 1);
+        REQUIRE(board.oGain(3, 4) == fresh.oGain(3, 4));
+        REQUIRE(board.liveTriplesAt(3, 4) == fresh.liveTriplesAt(3, 4));
+        board.reset();
+        fresh.reset();
+    }
+
+    SECTION("New game of the same size starts clean") {
+        Game game(5, GameMode::GENERAL);
+        game.makeMove(0, 0);
+        game.makeMove(1, 1);
+        game.newGame(5, GameMode::SIMPLE);
+        REQUIRE(game.getBoard().emptyCount() == 25);
+        REQUIRE(game.getBoard().hash() == Board(5).hash());
+        REQUIRE(game.getMode() == GameMode::SIMPLE);
+    }
+}
+
+TEST_CASE("Triple table tracks live and completed triples", "[board][triples]") {
+    SECTION("Empty board") {
+        // Rows and columns hold n - 2 triples per line, each diagonal
+        // direction (n - 2)^2
+        Board board(5, Board::TRACK_TRIPLES);
+        REQUIRE(board.liveTripleCount() == 2 * 5 * 3 + 2 * 3 * 3);
+        REQUIRE(board.nearCompleteTripleCount() == 0);
+        REQUIRE(board.liveTriplesAt(0, 0) == 3);
+        REQUIRE(board.liveTriplesAt(2, 2) == 4 * 3);
+    }
+
+    SECTION("Matches a recount through random play and unmake") {
+        srand(16);
+        std::mt19937 rng(16);
+        const int n = 6;
+        Board board(n, Board::TRACK_TRIPLES);
+        int dirs[4][2] = {{0, 1}, {1, 0}, {1, 1}, {-1, 1}};
+
+        for (int moves = 0; moves < 40; moves++) {
+            int row, col;
+            if (board.randomEmptyCell(row, col, rng)) {
+                board.makeMove(row, col, (rand() % 2) ? 'S' : 'O');
+            }
+            if (moves % 5 == 4) {
+                board.unmakeMove(row, col);
+            }
+
+            int live = 0, near = 0;
+            std::vector<int> perCell(n * n, 0);
+            for (int r = 0; r < n; r++) {
+                for (int c = 0; c < n; c++) {
+                    for (auto& d : dirs) {
+                        int r2 = r + 2 * d[0], c2 = c + 2 * d[1];
+                        if (r2 < 0 || r2 >= n || c2 < 0 || c2 >= n) continue;
+                        CellState want[3] = {CellState::S, CellState::O, CellState::S};
+                        int fits = 0;
+                        bool dead = false;
+                        for (int k = 0; k < 3; k++) {
+                            CellState cell = board.getCell(r + k * d[0], c + k * d[1]);
+                            if (cell == want[k]) fits++;
+                            else if (cell != CellState::EMPTY) dead = true;
+                        }
+                        if (dead || fits == 3) continue;
+                        live++;
+                        if (fits == 2) near++;
+                        for (int k = 0; k < 3; k++) {
+                            perCell[(r + k * d[0]) * n + c + k * d[1]]++;
+                        }
+                    }
+                }
+            }
+
+            REQUIRE(board.liveTripleCount() == live);
+            REQUIRE(board.nearCompleteTripleCount() == near);
+            REQUIRE(board.completedTripleCount() == board.countAllSOS());
+            for (int r = 0; r < n; r++) {
+                for (int c = 0; c < n; c++) {
+                    REQUIRE(board.liveTriplesAt(r, c) == perCell[r * n + c]);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Parallel board analysis matches the board's own counters", "[board][analysis]") {
+    srand(17);
+    std::mt19937 rng(17);
+    Board board(150, Board::TRACK_THREATS);
+    for (int i = 0; i < 15000; i++) {
+        int row, col;
+        board.randomEmptyCell(row, col, rng);
+        board.makeMove(row, col, (rand() % 3) ? 'S' : 'O');
+    }
+
+    long long sGains = 0, oGains = 0;
+    for (int r = 0; r < 150; r++) {
+        for (int c = 0; c < 150; c++) {
+            sGains += board.sGain(r, c);
+            oGains += board.oGain(r, c);
+        }
+    }
+
+    BoardAnalysis serial = analyzeBoard(board);
+    REQUIRE(serial.sosCount == board.countAllSOS());
+    REQUIRE(serial.emptyCells == board.emptyCount());
+    REQUIRE(serial.scoringCells == board.scoringMoveCount());
+    REQUIRE(serial.sGainTotal == sGains);
+    REQUIRE(serial.oGainTotal == oGains);
+
+    for (int threads : {1, 3, 8}) {
+        ThreadPool pool(threads);
+        BoardAnalysis parallel = analyzeBoard(board, pool);
+        REQUIRE(parallel.sosCount == serial.sosCount);
+        REQUIRE(parallel.emptyCells == serial.emptyCells);
+        REQUIRE(parallel.scoringCells == serial.scoringCells);
+        REQUIRE(parallel.sGainTotal == serial.sGainTotal);
+        REQUIRE(parallel.oGainTotal == serial.oGainTotal);
+    }
+}
+
+TEST_CASE("SIMD level names round trip", "[kernels]") {
+    for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::SSE42,
+                            SimdLevel::AVX2, SimdLevel::AVX512}) {
+        SimdLevel parsed;
+        REQUIRE(parseSimdLevel(simdLevelName(level), parsed));
+        REQUIRE(parsed == level);
+    }
+
+    SimdLevel unused;
+    REQUIRE(parseSimdLevel("sse5", unused) == false);
+    REQUIRE(activeSimdLevel() <= detectedSimdLevel());
+}
+
+// Triples through (row, col), with 'letter' in its slot, that hold exactly
+// one other fitting letter and nothing wrong
+static int bruteForceSetups(const Board& board, int row, int col, char letter) {
+    const int steps[4][2] = {{0, 1}, {1, 0}, {1, 1}, {-1, 1}};
+    int n = board.getSize();
+    int setups = 0;
+    for (const auto& step : steps) {
+        for (int k = 0; k < 3; k++) {
+            int startRow = row - k * step[0];
+            int startCol = col - k * step[1];
+            int endRow = startRow + 2 * step[0];
+            int endCol = startCol + 2 * step[1];
+            if (startRow < 0 || startRow >= n || startCol < 0 || startCol >= n ||
+                endRow < 0 || endRow >= n || endCol < 0 || endCol >= n) {
+                continue;
+            }
+            if ((k == 1) != (letter == 'O')) {
+                continue;
+            }
+            int fits = 0;
+            bool dead = false;
+            for (int j = 0; j < 3; j++) {
+                if (j == k) {
+                    continue;
+                }
+                CellState cell = board.getCell(startRow + j * step[0], startCol + j * step[1]);
+                CellState wanted = (j == 1) ? CellState::O : CellState::S;
+                if (cell == wanted) {
+                    fits++;
+                } else if (cell != CellState::EMPTY) {
+                    dead = true;
+                }
+            }
+            setups += !dead && fits == 1;
+        }
+    }
+    return setups;
+}
+
+TEST_CASE("Setup counts and safe cells match a rescan", "[board][threats]") {
+    srand(21);
+    std::mt19937 rng(21);
+    const int n = 7;
+    Board board(n, Board::TRACK_TRIPLES);
+
+    while (!board.isFull()) {
+        int safe = 0;
+        for (int row = 0; row < n; row++) {
+            for (int col = 0; col < n; col++) {
+                if (!board.isEmpty(row, col)) {
+                    continue;
+                }
+                int sSetups = bruteForceSetups(board, row, col, 'S');
+                int oSetups = bruteForceSetups(board, row, col, 'O');
+                REQUIRE(board.sSetups(row, col) == sSetups);
+                REQUIRE(board.oSetups(row, col) == oSetups);
+                safe += (sSetups == 0 || oSetups == 0);
+            }
+        }
+        REQUIRE(board.safeMoveCount() == safe);
+
+        int row, col;
+        board.randomEmptyCell(row, col, rng);
+        board.makeMove(row, col, (rand() % 2) ? 'S' : 'O');
+    }
+    REQUIRE(board.safeMoveCount() == 0);
+
+    // Unmake walks the counts back
+    board.reset();
+    REQUIRE(board.safeMoveCount() == n * n);
+}
+
+TEST_CASE("Greedy engine scores first and gives nothing away", "[engine]") {
+    srand(21);
+    std::mt19937 rng(21);
+
+    SECTION("Takes the biggest SOS") {
+        Board board(5, Board::TRACK_ENGINE);
+        board.makeMove(0, 0, 'S');
+        board.makeMove(0, 1, 'O');
+        board.makeMove(1, 1, 'O');
+        board.makeMove(2, 0, 'S');
+        board.makeMove(3, 3, 'S');
+        board.makeMove(3, 4, 'S');
+        // S at (0,2) finishes the top row and the anti-diagonal up from
+        // (2,0); S at (2,2) and O at (1,0) finish one SOS each
+        EngineMove move;
+        REQUIRE(board.scoringMoveCount() == 3);
+        REQUIRE(board.checkForSOS(0, 2, 'S') == 2);
+        REQUIRE(board.checkForSOS(2, 2, 'S') == 1);
+        REQUIRE(board.checkForSOS(1, 0, 'O') == 1);
+        REQUIRE(chooseGreedyMove(board, rng, move));
+        REQUIRE(move.row == 0);
+        REQUIRE(move.col == 2);
+        REQUIRE(move.letter == 'S');
+    }
+
+    SECTION("Random choices come from the caller's generator alone") {
+        Board board(9);
+        std::mt19937 first(3), second(3);
+        EngineMove a, b;
+        while (chooseGreedyMove(board, first, a)) {
+            rand();
+            REQUIRE(chooseGreedyMove(board, second, b));
+            REQUIRE((a.row == b.row && a.col == b.col && a.letter == b.letter));
+            board.makeMove(a.row, a.col, a.letter);
+        }
+    }
+
+    SECTION("Quiet moves leave the opponent nothing") {
+        for (int game = 0; game < 20; game++) {
+            Board board(8, Board::TRACK_ENGINE);
+            EngineMove move;
+            while (chooseGreedyMove(board, rng, move)) {
+                bool hadSafe = board.scoringMoveCount() == 0 && board.safeMoveCount() > 0;
+                REQUIRE(board.makeMove(move.row, move.col, move.letter));
+                if (hadSafe) {
+                    REQUIRE(board.scoringMoveCount() == 0);
+                }
+            }
+            REQUIRE(board.isFull());
+        }
+    }
+
+    SECTION("Beats random play in general games") {
+        int greedyWins = 0;
+        for (int round = 0; round < 20; round++) {
+            Game game(6, GameMode::GENERAL);
+            game.setComputerEngine(ComputerEngine::GREEDY);
+            while (game.getState() == GameState::ONGOING) {
+                if (game.getCurrentPlayer() == game.getPlayer1()) {
+                    REQUIRE(game.makeComputerMove());
+                } else {
+                    int row, col;
+                    game.getBoard().randomEmptyCell(row, col, rng);
+                    game.getCurrentPlayer()->setCurrentLetter((rand() % 2) ? 'S' : 'O');
+                    REQUIRE(game.makeMove(row, col));
+                }
+            }
+            greedyWins += game.getState() == GameState::PLAYER1_WIN;
+        }
+        REQUIRE(greedyWins >= 15);
+    }
+}
+
+// Exact value of the position for the side to move, by plain minimax
+static int bruteForceValue(Board& board, GameMode mode) {
+    if (board.isFull()) {
+        return 0;
+    }
+    int best = -2 * SearchEngine::WIN_SCORE;
+    for (int row = 0; row < board.getSize(); row++) {
+        for (int col = 0; col < board.getSize(); col++) {
+            if (!board.isEmpty(row, col)) {
+                continue;
+            }
+            for (char letter : {'S', 'O'}) {
+                int points = board.checkForSOS(row, col, letter);
+                int value;
+                if (points > 0 && mode == GameMode::SIMPLE) {
+                    value = SearchEngine::WIN_SCORE;
+                } else {
+                    board.makeMove(row, col, letter);
+                    value = points > 0 ? points + bruteForceValue(board, mode)
+                                       : -bruteForceValue(board, mode);
+                    board.unmakeMove(row, col);
+                }
+                best = std::max(best, value);
+            }
+        }
+    }
+    return best;
+}
+
+TEST_CASE("Search finds the exact value of small endgames", "[engine][search]") {
+    srand(22);
+    std::mt19937 rng(22);
+    SearchEngine engine;
+
+    for (int trial = 0; trial < 30; trial++) {
+        GameMode mode = (trial % 2) ? GameMode::GENERAL : GameMode::SIMPLE;
+        Board board(4);
+        // Random letters, but in simple mode stop before anyone has scored
+        while (board.emptyCount() > 6) {
+            int row, col;
+            board.randomEmptyCell(row, col, rng);
+            char letter = (rand() % 2) ? 'S' : 'O';
+            if (mode == GameMode::SIMPLE && board.checkForSOS(row, col, letter) > 0) {
+                continue;
+            }
+            board.makeMove(row, col, letter);
+        }
+
+        int expected = bruteForceValue(board, mode);
+        SearchResult result;
+        REQUIRE(engine.search(board, mode, {0, 0, 0}, result));
+        if (mode == GameMode::SIMPLE) {
+            // Wins are discounted by how soon they come; only the outcome matters
+            REQUIRE((result.score > 0) == (expected > 0));
+            REQUIRE((result.score < 0) == (expected < 0));
+        } else {
+            REQUIRE(result.score == expected);
+        }
+
+        // The chosen move achieves the value
+        int points = board.checkForSOS(result.move.row, result.move.col, result.move.letter);
+        REQUIRE(board.makeMove(result.move.row, result.move.col, result.move.letter));
+        if (mode == GameMode::GENERAL) {
+            int after = bruteForceValue(board, mode);
+            REQUIRE((points > 0 ? points + after : -after) == expected);
+        }
+    }
+}
+
+TEST_CASE("Search respects its budgets", "[engine][search]") {
+    SearchEngine engine;
+    Board board(30);
+    board.makeMove(10, 10, 'S');
+    board.makeMove(10, 11, 'O');
+
+    SECTION("Node budget") {
+        SearchResult result;
+        REQUIRE(engine.search(board, GameMode::GENERAL, {0, 0, 5000}, result));
+        REQUIRE(result.nodes < 5000 + 2048);
+        REQUIRE(result.depth >= 1);
+        // Taking the free SOS comes first
+        REQUIRE(result.move.row == 10);
+        REQUIRE(result.move.col == 12);
+        REQUIRE(result.move.letter == 'S');
+    }
+
+    SECTION("Time budget") {
+        auto start = std::chrono::steady_clock::now();
+        SearchResult result;
+        REQUIRE(engine.search(board, GameMode::SIMPLE, {0, 50, 0}, result));
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        REQUIRE(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() < 500);
+        REQUIRE(board.checkForSOS(result.move.row, result.move.col, result.move.letter) > 0);
+    }
+
+    SECTION("Full board") {
+        Board full(3);
+        for (int i = 0; i < 9; i++) {
+            full.makeMove(i / 3, i % 3, 'O');
+        }
+        SearchResult result;
+        REQUIRE(engine.search(full, GameMode::GENERAL, {0, 0, 0}, result) == false);
+    }
+}
+
+TEST_CASE("Transposition table stores, replaces and ages entries", "[engine][table]") {
+    TranspositionTable table;
+    table.resize(1);
+    REQUIRE(table.bucketCount() == 16384);
+    REQUIRE(table.memoryBytes() == 1024 * 1024);
+
+    // Keys sharing a bucket: same low bits, different check halves
+    auto key = [](uint64_t n) { return (n << 32) | 7; };
+    TranspositionTable::Entry entry;
+    REQUIRE(table.probe(key(1), entry) == false);
+
+    table.store(key(1), 5, -3, TranspositionTable::LOWER, 42);
+    REQUIRE(table.probe(key(1), entry));
+    REQUIRE(entry.depth == 5);
+    REQUIRE(entry.score == -3);
+    REQUIRE(entry.bound == TranspositionTable::LOWER);
+    REQUIRE(entry.move == 42);
+
+    // Same position again replaces in place, keeping the move if none is given
+    table.store(key(1), 2, 7, TranspositionTable::EXACT, TranspositionTable::NO_MOVE);
+    REQUIRE(table.probe(key(1), entry));
+    REQUIRE(entry.score == 7);
+    REQUIRE(entry.move == 42);
+
+    SECTION("A full bucket gives up its shallowest entry") {
+        table.store(key(1), 9, 0, TranspositionTable::EXACT, 1);
+        table.store(key(2), 3, 0, TranspositionTable::EXACT, 2);
+        table.store(key(3), 6, 0, TranspositionTable::EXACT, 3);
+        table.store(key(4), 8, 0, TranspositionTable::EXACT, 4);
+        table.store(key(5), 4, 0, TranspositionTable::EXACT, 5);
+        REQUIRE(table.probe(key(2), entry) == false);
+        REQUIRE(table.probe(key(5), entry));
+        REQUIRE(table.probe(key(1), entry));
+    }
+
+    SECTION("Old searches' entries go first") {
+        table.store(key(1), 9, 0, TranspositionTable::EXACT, 1);
+        table.store(key(2), 8, 0, TranspositionTable::EXACT, 2);
+        table.store(key(3), 8, 0, TranspositionTable::EXACT, 3);
+        table.store(key(4), 8, 0, TranspositionTable::EXACT, 4);
+        table.newSearch();
+        table.newSearch();
+        table.store(key(2), 8, 0, TranspositionTable::EXACT, 2);
+        table.store(key(3), 8, 0, TranspositionTable::EXACT, 3);
+        table.store(key(4), 8, 0, TranspositionTable::EXACT, 4);
+        // Deepest, but two searches old
+        table.store(key(5), 2, 0, TranspositionTable::EXACT, 5);
+        REQUIRE(table.probe(key(1), entry) == false);
+        REQUIRE(table.probe(key(5), entry));
+    }
+
+    SECTION("Clear empties the table") {
+        table.clear();
+        REQUIRE(table.probe(key(1), entry) == false);
+        REQUIRE(table.usagePermille() == 0);
+    }
+}
+
+TEST_CASE("Transposition table saves search work", "[engine][table]") {
+    Board board(5);
+    board.makeMove(2, 2, 'O');
+    board.makeMove(0, 0, 'S');
+
+    SearchEngine withTable;
+    SearchEngine tiny;
+    tiny.setTableSize(0);
+
+    SearchResult full, small;
+    REQUIRE(withTable.search(board, GameMode::GENERAL, {4, 0, 0}, full));
+    REQUIRE(tiny.search(board, GameMode::GENERAL, {4, 0, 0}, small));
+    REQUIRE(full.score == small.score);
+    REQUIRE(full.tableHits > 0);
+    REQUIRE(full.nodes < small.nodes);
+}
+
+TEST_CASE("MCTS finds obvious moves within its limits", "[engine][mcts]") {
+    srand(24);
+    MctsEngine engine;
+
+    SECTION("Takes a simple-mode win") {
+        Board board(8);
+        board.makeMove(3, 3, 'S');
+        board.makeMove(3, 4, 'O');
+        MctsResult result;
+        REQUIRE(engine.search(board, GameMode::SIMPLE, 0, {0, 3000, 0, 1}, result));
+        REQUIRE(result.playouts == 3000);
+        REQUIRE(board.checkForSOS(result.move.row, result.move.col, result.move.letter) > 0);
+        REQUIRE(result.winRate > 0.9);
+    }
+
+    SECTION("Avoids handing over a simple-mode win") {
+        Board board(4, Board::TRACK_THREATS);
+        board.makeMove(0, 0, 'S');
+        MctsResult result;
+        REQUIRE(engine.search(board, GameMode::SIMPLE, 0, {0, 20000, 0, 1}, result));
+        REQUIRE(board.makeMove(result.move.row, result.move.col, result.move.letter));
+        REQUIRE(board.scoringMoveCount() == 0);
+    }
+
+    SECTION("Time limit and node cap") {
+        Board board(12);
+        MctsResult result;
+        auto start = std::chrono::steady_clock::now();
+        REQUIRE(engine.search(board, GameMode::GENERAL, 0, {50, 0, 5000, 1}, result));
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        REQUIRE(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() < 500);
+        REQUIRE(result.playouts > 0);
+        REQUIRE(result.playoutsPerSecond > 0);
+        // The root's children always exist; anything past the cap does not
+        REQUIRE(result.nodes <= 5000 + 1);
+        REQUIRE(board.isEmpty(result.move.row, result.move.col));
+    }
+
+    SECTION("The engine's own seed makes single-worker searches repeatable") {
+        Board board(6);
+        board.makeMove(2, 2, 'O');
+        srand(7);
+        MctsEngine first;
+        srand(7);
+        MctsEngine second;
+        for (int i = 0; i < 2; i++) {
+            MctsResult a, b;
+            REQUIRE(first.search(board, GameMode::GENERAL, 0, {0, 500, 0, 1}, a));
+            rand();  // searches draw nothing from rand()
+            REQUIRE(second.search(board, GameMode::GENERAL, 0, {0, 500, 0, 1}, b));
+            REQUIRE(a.move.row == b.move.row);
+            REQUIRE(a.move.col == b.move.col);
+            REQUIRE(a.move.letter == b.move.letter);
+            REQUIRE(a.winRate == b.winRate);
+        }
+    }
+
+    SECTION("Plays whole games through Game") {
+        for (GameMode mode : {GameMode::SIMPLE, GameMode::GENERAL}) {
+            Game game(5, mode);
+            game.setComputerEngine(ComputerEngine::MCTS);
+            game.setMctsLimits({0, 200, 0, 1});
+            while (game.getState() == GameState::ONGOING) {
+                REQUIRE(game.makeComputerMove());
+            }
+        }
+    }
+}
+
+TEST_CASE("MCTS workers share one tree", "[engine][mcts]") {
+    srand(25);
+    MctsEngine engine;
+
+    SECTION("Playout limit is exact across workers") {
+        Board board(8);
+        board.makeMove(3, 3, 'S');
+        board.makeMove(3, 4, 'O');
+        MctsResult result;
+        REQUIRE(engine.search(board, GameMode::SIMPLE, 0, {0, 4000, 0, 4}, result));
+        REQUIRE(result.playouts == 4000);
+        REQUIRE(board.checkForSOS(result.move.row, result.move.col, result.move.letter) > 0);
+        REQUIRE(result.winRate > 0.9);
+    }
+
+    SECTION("Searches again with a different worker count and a tight pool") {
+        Board board(10);
+        MctsResult result;
+        for (int threads : {3, 1, 2}) {
+            REQUIRE(engine.search(board, GameMode::GENERAL, 0, {0, 3000, 1000, threads}, result));
+            REQUIRE(result.playouts == 3000);
+            REQUIRE(result.nodes <= 1000);
+            REQUIRE(board.isEmpty(result.move.row, result.move.col));
+        }
+    }
+
+    SECTION("A pool with no room below the root stays exactly full") {
+        // 4x4: the root's 30 children fit, no second expansion of 28 does
+        Board board(4);
+        board.makeMove(0, 0, 'S');
+        MctsResult result;
+        REQUIRE(engine.search(board, GameMode::GENERAL, 0, {0, 2000, 40, 4}, result));
+        REQUIRE(result.playouts == 2000);
+        REQUIRE(result.nodes == 31);
+        REQUIRE(board.isEmpty(result.move.row, result.move.col));
+    }
+
+    SECTION("The root's children are spaced out when the pool has room") {
+        Board board(4);
+        board.makeMove(0, 0, 'S');
+        MctsResult result;
+        REQUIRE(engine.search(board, GameMode::GENERAL, 0, {0, 1, 0, 1}, result));
+        REQUIRE(result.nodes == 1 + 30 * 5);
+        REQUIRE(engine.search(board, GameMode::GENERAL, 0, {0, 4000, 0, 4}, result));
+        REQUIRE(board.isEmpty(result.move.row, result.move.col));
+        REQUIRE(result.playouts == 4000);
+    }
+}
+
+TEST_CASE("Board tables are opt-in and build from any position", "[board]") {
+    srand(26);
+    std::mt19937 rng(26);
+    const int n = 8;
+    Board plain(n);
+    Board tracked(n, Board::TRACK_ENGINE);
+    REQUIRE(plain.getTracking() == Board::TRACK_NONE);
+    REQUIRE(tracked.tracks(Board::TRACK_THREATS | Board::TRACK_TRIPLES));
+
+    for (int i = 0; i < 25; i++) {
+        int row, col;
+        plain.randomEmptyCell(row, col, rng);
+        char letter = (rand() % 2) ? 'S' : 'O';
+        plain.makeMove(row, col, letter);
+        tracked.makeMove(row, col, letter);
+    }
+
+    // Scoring without the code table reads the cells directly
+    Board::SOSLine plainLines[Board::MAX_SOS_PER_MOVE];
+    Board::SOSLine trackedLines[Board::MAX_SOS_PER_MOVE];
+    for (int r = 0; r < n; r++) {
+        for (int c = 0; c < n; c++) {
+            REQUIRE(plain.checkForSOS(r, c, 'S') == tracked.checkForSOS(r, c, 'S'));
+            REQUIRE(plain.checkForSOS(r, c, 'O') == tracked.checkForSOS(r, c, 'O'));
+            int count = plain.findSOS(r, c, plainLines, Board::MAX_SOS_PER_MOVE);
+            REQUIRE(count == tracked.findSOS(r, c, trackedLines, Board::MAX_SOS_PER_MOVE));
+            for (int i = 0; i < count; i++) {
+                REQUIRE(plainLines[i].startRow == trackedLines[i].startRow);
+                REQUIRE(plainLines[i].startCol == trackedLines[i].startCol);
+                REQUIRE(plainLines[i].endRow == trackedLines[i].endRow);
+                REQUIRE(plainLines[i].endCol == trackedLines[i].endCol);
+            }
+        }
+    }
+
+    // Switched on mid-game, the tables match ones kept from the start
+    plain.setTracking(tracked.getTracking());
+    REQUIRE(plain.scoringMoveCount() == tracked.scoringMoveCount());
+    REQUIRE(plain.safeMoveCount() == tracked.safeMoveCount());
+    REQUIRE(plain.liveTripleCount() == tracked.liveTripleCount());
+    REQUIRE(plain.nearCompleteTripleCount() == tracked.nearCompleteTripleCount());
+    REQUIRE(plain.completedTripleCount() == tracked.completedTripleCount());
+    for (int r = 0; r < n; r++) {
+        for (int c = 0; c < n; c++) {
+            REQUIRE(plain.checkForSOS(r, c, 'S') == tracked.checkForSOS(r, c, 'S'));
+            REQUIRE(plain.checkForSOS(r, c, 'O') == tracked.checkForSOS(r, c, 'O'));
+            REQUIRE(plain.checkForSOS(r, c) == tracked.checkForSOS(r, c));
+            REQUIRE(plain.sGain(r, c) == tracked.sGain(r, c));
+            REQUIRE(plain.oGain(r, c) == tracked.oGain(r, c));
+            REQUIRE(plain.sSetups(r, c) == tracked.sSetups(r, c));
+            REQUIRE(plain.oSetups(r, c) == tracked.oSetups(r, c));
+            REQUIRE(plain.liveTriplesAt(r, c) == tracked.liveTriplesAt(r, c));
+        }
+    }
+
+    // Engines take plain boards too
+    tracked.setTracking(Board::TRACK_NONE);
+    EngineMove move;
+    REQUIRE(chooseGreedyMove(tracked, rng, move));
+    REQUIRE(tracked.isEmpty(move.row, move.col));
+}
+
+TEST_CASE("Layout boards match Board", "[board][layout]") {
+    srand(19);
+    for (int n : {3, 6, 8, 13, 30}) {
+        LayoutBoard<RowMajorLayout> rowMajor(n);
+        LayoutBoard<TiledLayout> tiled(n);
+        LayoutBoard<MortonLayout> morton(n);
+        compareWithBoard(rowMajor, n);
+        compareWithBoard(tiled, n);
+        compareWithBoard(morton, n);
+    }
+
+    SECTION("Tiled and Morton keep a 4x4 aligned block in one cache line") {
+        LayoutBoard<TiledLayout> tiled(64);
+        LayoutBoard<MortonLayout> morton(64);
+        for (int row = 6; row < 10; row++) {
+            for (int col = 6; col < 10; col++) {
+                REQUIRE(tiled.offsetOf(row, col) / 64 == tiled.offsetOf(6, 6) / 64);
+                REQUIRE(morton.offsetOf(row, col) / 64 == morton.offsetOf(6, 6) / 64);
+            }
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#include "threadpool.h"
+
+ThreadPool::ThreadPool(int threadCount) : pending(0), stopping(false) {
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+        if (threadCount <= 0) {
+            threadCount = 1;
+        }
+    }
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskReady.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push(std::move(task));
+        pending++;
+    }
+    taskReady.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    allDone.wait(lock, [this] { return pending == 0; });
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskReady.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;  // stopping and nothing left to run
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+
+        task();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) {
+            allDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads pulling tasks from a shared queue
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskReady;
+    std::condition_variable allDone;
+    int pending;     // queued plus running tasks
+    bool stopping;
+
+    void workerLoop();
+
+public:
+    // threadCount <= 0 uses one thread per hardware thread
+    explicit ThreadPool(int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int threadCount() const { return static_cast<int>(workers.size()); }
+    void submit(std::function<void()> task);
+    // Blocks until every submitted task has finished
+    void wait();
+};
+
+#endif // THREADPOOL_H
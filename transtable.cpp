@@ -0,0 +1,96 @@
+#include "transtable.h"
+#include <algorithm>
+#include <cstring>
+
+static_assert(sizeof(TranspositionTable::Entry) == 16, "four entries per cache line");
+static_assert(sizeof(TranspositionTable::Bucket) == 64, "one bucket per cache line");
+
+namespace {
+// Depth an entry loses per search it has sat unused, when picking a victim
+const int AGE_PENALTY = 4;
+}
+
+TranspositionTable::TranspositionTable() : mask(0), generation(0) {}
+
+void TranspositionTable::resize(int megabytes) {
+    size_t budget = static_cast<size_t>(std::max(megabytes, 0)) * 1024 * 1024;
+    size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= budget) {
+        count *= 2;
+    }
+    buckets.assign(count, Bucket());
+    mask = count - 1;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    std::memset(static_cast<void*>(buckets.data()), 0, buckets.size() * sizeof(Bucket));
+    generation = 0;
+}
+
+void TranspositionTable::newSearch() {
+    generation++;
+}
+
+bool TranspositionTable::probe(uint64_t key, Entry& out) const {
+    if (buckets.empty()) {
+        return false;
+    }
+    const Bucket& bucket = buckets[key & mask];
+    uint32_t check = static_cast<uint32_t>(key >> 32);
+    for (const Entry& entry : bucket.entries) {
+        if (entry.bound != NONE && entry.check == check) {
+            out = entry;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, int depth, int score, Bound bound, uint32_t move) {
+    if (buckets.empty()) {
+        return;
+    }
+    Bucket& bucket = buckets[key & mask];
+    uint32_t check = static_cast<uint32_t>(key >> 32);
+
+    Entry* victim = nullptr;
+    int victimValue = 0;
+    for (Entry& entry : bucket.entries) {
+        if (entry.bound == NONE || entry.check == check) {
+            victim = &entry;
+            break;
+        }
+        // Generations wrap at 256; the difference still counts searches
+        int age = static_cast<uint8_t>(generation - entry.generation);
+        int value = entry.depth - AGE_PENALTY * age;
+        if (!victim || value < victimValue) {
+            victim = &entry;
+            victimValue = value;
+        }
+    }
+
+    if (victim->bound != NONE && victim->check == check && move == NO_MOVE) {
+        move = victim->move;
+    }
+    victim->check = check;
+    victim->score = score;
+    victim->move = move;
+    victim->depth = static_cast<uint8_t>(std::min(depth, 255));
+    victim->bound = bound;
+    victim->generation = generation;
+}
+
+int TranspositionTable::usagePermille() const {
+    size_t sample = std::min<size_t>(buckets.size(), 1000);
+    if (sample == 0) {
+        return 0;
+    }
+    size_t used = 0;
+    for (size_t b = 0; b < sample; b++) {
+        for (const Entry& entry : buckets[b].entries) {
+            used += entry.bound != NONE;
+        }
+    }
+    return static_cast<int>(used * 1000 / (sample * BUCKET_ENTRIES));
+}
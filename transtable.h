@@ -0,0 +1,69 @@
+#ifndef TRANSTABLE_H
+#define TRANSTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Fixed-size hash table of search results keyed by position hash. Entries
+// are 16 bytes in buckets of four, one 64-byte cache line per bucket, so a
+// probe touches a single line. The bucket comes from the low bits of the
+// key and the high 32 bits verify the entry.
+class TranspositionTable {
+public:
+    enum Bound : uint8_t {
+        NONE,   // empty slot
+        EXACT,
+        LOWER,  // failed high: score is a lower bound
+        UPPER   // failed low: score is an upper bound
+    };
+
+    static constexpr uint32_t NO_MOVE = 0xFFFFFFFF;
+
+    struct Entry {
+        uint32_t check;     // high half of the key
+        int32_t score;
+        uint32_t move;      // (row * size + col) * 2 + (letter == 'O'), or NO_MOVE
+        uint8_t depth;
+        uint8_t bound;
+        uint8_t generation;
+        uint8_t unused;
+    };
+
+    static constexpr int BUCKET_ENTRIES = 4;
+
+    struct alignas(64) Bucket {
+        Entry entries[BUCKET_ENTRIES];
+    };
+
+    // No memory until resize
+    TranspositionTable();
+
+    // Largest power-of-two bucket count within 'megabytes' (at least one
+    // bucket); drops all entries
+    void resize(int megabytes);
+    size_t bucketCount() const { return buckets.size(); }
+    size_t memoryBytes() const { return buckets.size() * sizeof(Bucket); }
+    bool empty() const { return buckets.empty(); }
+
+    void clear();
+    // Starts a new search: entries from earlier searches become the first
+    // to be replaced, without clearing them
+    void newSearch();
+
+    bool probe(uint64_t key, Entry& out) const;
+    // Replaces the same position's entry, else an empty slot, else the
+    // entry with the lowest depth after an aging penalty. An entry for the
+    // same position keeps its move when the new result has none.
+    void store(uint64_t key, int depth, int score, Bound bound, uint32_t move);
+
+    // Share of slots in use, per thousand, sampled from the first 1000 buckets
+    int usagePermille() const;
+
+private:
+    std::vector<Bucket> buckets;
+    uint64_t mask;
+    uint8_t generation;
+};
+
+#endif // TRANSTABLE_H
@@ -0,0 +1,37 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+#include "enums.h"
+
+// Zobrist keys are derived on the fly with a splitmix64 finaliser instead
+// of being stored in tables, so boards of any size get fixed, reproducible
+// keys without per-size allocation.
+namespace zobrist {
+
+inline uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Key of the empty board of the given size
+inline uint64_t boardKey(int size) {
+    return mix(0xB0A4D000ULL ^ static_cast<uint64_t>(size));
+}
+
+// Key of a letter on cell row * size + col
+inline uint64_t cellKey(int size, int cell, CellState letter) {
+    uint64_t x = (static_cast<uint64_t>(size) << 40) ^
+                 (static_cast<uint64_t>(cell) << 2) ^
+                 static_cast<uint64_t>(letter);
+    return mix(x);
+}
+
+const uint64_t SIDE_KEY = 0x3C6EF372FE94F82BULL;     // player 2 to move
+const uint64_t GENERAL_KEY = 0xA54FF53A5F1D36F1ULL;  // general mode
+
+}
+
+#endif // ZOBRIST_H